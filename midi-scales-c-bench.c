@@ -0,0 +1,109 @@
+/**
+ * @file midi-scales-c-bench.c
+ * @author Jan-Willem Smaal <usenet@gispen.org>
+ * @date 19/10/2026
+ * @copyright APACHE-2.0
+ *
+ * Compares one call per note against the batched calls
+ * of libmidiscales.so.
+ */
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "midi-scales-c.h"
+
+#define COUNT   4096
+#define ROUNDS  1000
+
+static double Now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void Report(const char *what, double single, double batch)
+{
+    double n = (double)COUNT * ROUNDS;
+
+    printf("%-10s per note %6.2f ns  batched %6.2f ns  (%.1fx)\n",
+           what, single * 1e9 / n, batch * 1e9 / n, single / batch);
+}
+
+
+int main(void)
+{
+    int i, r;
+    unsigned int sum = 0;
+    double t0, t1, t2;
+    static uint8_t notes[COUNT];
+    static uint8_t degrees[COUNT];
+    static uint8_t out[COUNT];
+    static uint32_t chords[COUNT];
+    static char names[COUNT * MSC_NOTE_NAME_SIZE];
+    msc_scale *scale = msc_scale_new(MSC_HARMONIC_MINOR, 0);
+
+    if (scale == NULL) {
+        return 1;
+    }
+    srand(1);
+    for (i = 0; i < COUNT; i++) {
+        notes[i] = rand() % 128;
+        degrees[i] = rand() % 7;
+    }
+
+    t0 = Now();
+    for (r = 0; r < ROUNDS; r++) {
+        for (i = 0; i < COUNT; i++) {
+            out[i] = msc_quantize_note(scale, 57, notes[i]);
+        }
+        sum += out[r % COUNT];
+    }
+    t1 = Now();
+    for (r = 0; r < ROUNDS; r++) {
+        msc_quantize(scale, 57, notes, out, COUNT);
+        sum += out[r % COUNT];
+    }
+    t2 = Now();
+    Report("quantize", t1 - t0, t2 - t1);
+
+    t0 = Now();
+    for (r = 0; r < ROUNDS; r++) {
+        for (i = 0; i < COUNT; i++) {
+            msc_chord(scale, 57, MSC_CHORD_SEVENTH, degrees[i], &chords[i]);
+        }
+        sum += chords[r % COUNT];
+    }
+    t1 = Now();
+    for (r = 0; r < ROUNDS; r++) {
+        msc_chords(scale, 57, MSC_CHORD_SEVENTH, degrees, chords, COUNT);
+        sum += chords[r % COUNT];
+    }
+    t2 = Now();
+    Report("chords", t1 - t0, t2 - t1);
+
+    t0 = Now();
+    for (r = 0; r < ROUNDS; r++) {
+        for (i = 0; i < COUNT; i++) {
+            msc_note_name(notes[i], MSC_FLATS, names + i * MSC_NOTE_NAME_SIZE);
+        }
+        sum += names[r % COUNT];
+    }
+    t1 = Now();
+    for (r = 0; r < ROUNDS; r++) {
+        msc_note_names(notes, COUNT, MSC_FLATS, names);
+        sum += names[r % COUNT];
+    }
+    t2 = Now();
+    Report("names", t1 - t0, t2 - t1);
+
+    msc_scale_free(scale);
+    // Keep the compiler from dropping the loops
+    printf("(%u)\n", sum);
+    return 0;
+}
+
+/* EOF */
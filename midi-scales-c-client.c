@@ -0,0 +1,93 @@
+/**
+ * @file midi-scales-c-client.c
+ * @author Jan-Willem Smaal <usenet@gispen.org>
+ * @date 19/10/2026
+ * @copyright APACHE-2.0
+ *
+ * Small C client of libmidiscales.so, exits non zero on a mismatch.
+ */
+#include <stdio.h>
+#include <string.h>
+
+#include "midi-scales-c.h"
+
+static int failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+
+int main(void)
+{
+    int i;
+    uint8_t rootnote = 60;
+    uint8_t notes[12];
+    uint8_t in[5] = {60, 61, 66, 70, 127};
+    uint8_t out[5];
+    uint8_t degrees[7] = {0, 1, 2, 3, 4, 5, 6};
+    uint32_t chords[7];
+    char names[5 * MSC_NOTE_NAME_SIZE];
+    char name[MSC_NOTE_NAME_SIZE];
+    msc_scale *scale;
+
+    CHECK(msc_abi_version() == MSC_ABI_VERSION);
+
+    // Out of range kinds and modes are refused
+    CHECK(msc_scale_new(-1, 0) == NULL);
+    CHECK(msc_scale_new(MSC_MINOR_PENTATONIC + 1, 0) == NULL);
+    CHECK(msc_scale_new(MSC_MAJOR, 7) == NULL);
+    CHECK(msc_scale_new(MSC_GYPSY, 1) == NULL);
+
+    scale = msc_scale_new(MSC_MAJOR, 0);
+    CHECK(scale != NULL);
+    if (scale == NULL) {
+        return 1;
+    }
+    CHECK(msc_scale_size(scale) == 7);
+    CHECK(msc_scale_modes(scale) == 7);
+    CHECK(msc_scale_mask(scale) == 0xab5);
+    CHECK(msc_scale_notes(scale, rootnote, notes, 6) == MSC_ENOSPACE);
+    CHECK(msc_scale_notes(scale, rootnote, notes, 12) == 7);
+    CHECK(notes[0] == 60 && notes[2] == 64 && notes[6] == 71);
+
+    // C major: C# goes down to C, F# down to F, A# down to A
+    msc_quantize(scale, rootnote, in, out, 5);
+    CHECK(out[0] == 60 && out[1] == 60 && out[2] == 65 && out[3] == 69);
+    CHECK(out[4] == 127);
+    for (i = 0; i < 5; i++) {
+        CHECK(msc_quantize_note(scale, rootnote, in[i]) == out[i]);
+    }
+
+    // Triads on every degree, ii is D minor: root D, mask 0x89
+    CHECK(msc_chords(scale, rootnote, MSC_CHORD_BASIC, degrees, chords, 7) == MSC_OK);
+    CHECK((chords[0] & 0x7f) == 60 && ((chords[0] >> 14) & 0xfff) == 0x91);
+    CHECK((chords[1] & 0x7f) == 62 && ((chords[1] >> 14) & 0xfff) == 0x89);
+    CHECK(msc_chords(scale, rootnote, MSC_CHORD_SUS4 + 1, degrees, chords, 7) == MSC_EINVAL);
+    for (i = 0; i < 7; i++) {
+        uint32_t chord;
+        CHECK(msc_chord(scale, rootnote, MSC_CHORD_BASIC, degrees[i], &chord) == MSC_OK);
+        CHECK(chord == chords[i]);
+    }
+
+    msc_note_names(in, 5, MSC_FLATS, names);
+    CHECK(strcmp(names, "C") == 0);
+    CHECK(strcmp(names + MSC_NOTE_NAME_SIZE, "Db") == 0);
+    CHECK(strcmp(names + 3 * MSC_NOTE_NAME_SIZE, "Bb") == 0);
+    msc_note_name(61, MSC_OCTAVE, name);
+    CHECK(strcmp(name, "C#3") == 0);
+
+    CHECK(msc_scale_set(scale, MSC_MAJOR, 9) == MSC_EINVAL);
+    CHECK(msc_scale_set(scale, MSC_MINOR_PENTATONIC, 0) == MSC_OK);
+    CHECK(msc_scale_size(scale) == 5);
+    msc_scale_free(scale);
+
+    printf("%s\n", failures ? "FAILED" : "OK");
+    return failures ? 1 : 0;
+}
+
+/* EOF */
@@ -0,0 +1,316 @@
+/**
+ * @file midi-scales-c.cpp
+ * @author Jan-Willem Smaal <usenet@gispen.org>
+ * @date 19/10/2026
+ * @copyright APACHE 2.0
+ */
+#include <string.h>
+#include <new>
+#include <string>
+#include <utility>
+
+#include "midi-scales.h"
+#include "midi-scales-c.h"
+
+static_assert(MSC_MINOR_PENTATONIC + 1 == Scale::KINDS,
+              "msc_scale_kind out of sync with Scale::ScaleKinds");
+static_assert(MSC_CHORD_SUS4 == (int)Chord::Kinds::SUS4,
+              "msc_chord_kind out of sync with Chord::Kinds");
+
+
+/*
+ * The opaque handle, keeps the Scale and everything
+ * that can be worked out once per scale.
+ */
+struct msc_scale {
+    msc_scale(Scale::ScaleKinds kindOfScale, uint8_t modeOf)
+        : scale(kindOfScale, modeOf) {
+    }
+    Scale scale;
+    uint16_t mask;
+    // Semitones to the nearest scale note below and above
+    // for every pitch class
+    int8_t down[12];
+    int8_t up[12];
+    // Semitones above the root and interval mask of every kind
+    // of chord for every degree of the scale
+    uint8_t offset[12];
+    uint16_t chords[12][Chord::KINDS];
+};
+
+
+/** Kinds and modes out of range would index past the scale tables
+ */
+static bool ValidScale(int kind, int mode)
+{
+    int modes;
+
+    if (kind < MSC_CHROMATIC || kind > MSC_MINOR_PENTATONIC || mode < 0) {
+        return false;
+    }
+    modes = Scale::Modes((Scale::ScaleKinds)kind);
+    return mode < (modes ? modes : 1);
+}
+
+
+static void Prepare(msc_scale *scale)
+{
+    int i, d;
+    unsigned int k, n;
+    PackedChord diatonic[12 * Chord::KINDS];
+
+    scale->mask = scale->scale.Mask();
+    for (i = 0; i < 12; i++) {
+        scale->down[i] = 0;
+        scale->up[i] = 0;
+        for (d = 0; d < 12; d++) {
+            if (scale->mask & (1 << ((i + 12 - d) % 12))) {
+                scale->down[i] = -d;
+                break;
+            }
+        }
+        for (d = 0; d < 12; d++) {
+            if (scale->mask & (1 << ((i + d) % 12))) {
+                scale->up[i] = d;
+                break;
+            }
+        }
+    }
+
+    n = Chord::Diatonic(scale->scale, 0, diatonic, 12 * Chord::KINDS) / Chord::KINDS;
+    for (i = 0; i < (int)n; i++) {
+        scale->offset[i] = diatonic[i * Chord::KINDS].Root();
+        for (k = 0; k < Chord::KINDS; k++) {
+            scale->chords[i][k] = diatonic[i * Chord::KINDS + k].Mask();
+        }
+    }
+}
+
+
+/** Note names for every flag combination, built on first use
+ */
+struct NoteNames {
+    NoteNames() {
+        unsigned int flags, note;
+        std::string str;
+
+        for (flags = 0; flags < 4; flags++) {
+            for (note = 0; note < 256; note++) {
+                str = Scale::NoteToText(note,
+                                        flags & MSC_FLATS,
+                                        flags & MSC_OCTAVE);
+                strncpy(name[flags][note], str.c_str(), MSC_NOTE_NAME_SIZE - 1);
+                name[flags][note][MSC_NOTE_NAME_SIZE - 1] = '\0';
+            }
+        }
+    }
+    char name[4][256][MSC_NOTE_NAME_SIZE];
+};
+
+static const NoteNames &Names()
+{
+    static const NoteNames names;
+    return names;
+}
+
+
+//-----------------------------------------------------------------
+
+unsigned int msc_abi_version(void)
+{
+    return MSC_ABI_VERSION;
+}
+
+
+msc_scale *msc_scale_new(int kind, int mode)
+{
+    msc_scale *scale;
+
+    if (!ValidScale(kind, mode)) {
+        return NULL;
+    }
+    // The Scale names are std::strings, nothing may throw past
+    // the C interface
+    try {
+        scale = new (std::nothrow) msc_scale((Scale::ScaleKinds)kind, mode);
+    }
+    catch (...) {
+        return NULL;
+    }
+    if (scale != NULL) {
+        Prepare(scale);
+    }
+    return scale;
+}
+
+
+void msc_scale_free(msc_scale *scale)
+{
+    delete scale;
+}
+
+
+int msc_scale_set(msc_scale *scale, int kind, int mode)
+{
+    if (scale == NULL || !ValidScale(kind, mode)) {
+        return MSC_EINVAL;
+    }
+    // Build the new Scale first, moving it in can't throw so the
+    // handle is left as it was when out of memory
+    try {
+        Scale scl((Scale::ScaleKinds)kind, mode);
+        scale->scale = std::move(scl);
+    }
+    catch (...) {
+        return MSC_EINVAL;
+    }
+    Prepare(scale);
+    return MSC_OK;
+}
+
+
+int msc_scale_size(const msc_scale *scale)
+{
+    return scale->scale.notes;
+}
+
+
+int msc_scale_modes(const msc_scale *scale)
+{
+    return scale->scale.modes;
+}
+
+
+uint16_t msc_scale_mask(const msc_scale *scale)
+{
+    return scale->mask;
+}
+
+
+int msc_scale_notes(const msc_scale *scale,
+                    uint8_t rootnote,
+                    uint8_t *notes,
+                    size_t count)
+{
+    unsigned int i;
+    unsigned int tmp = rootnote;
+
+    if (count < scale->scale.notes) {
+        return MSC_ENOSPACE;
+    }
+    for (i = 0; i < scale->scale.notes; i++) {
+        notes[i] = Scale::FoldNote(tmp);
+        tmp = tmp + *(scale->scale.ptrToScale + i);
+    }
+    return scale->scale.notes;
+}
+
+
+static inline uint8_t Quantize(const msc_scale *scale,
+                               uint8_t rootnote,
+                               uint8_t note)
+{
+    int pc = ((int)note - rootnote) % 12;
+    int down, up;
+
+    if (pc < 0) {
+        pc += 12;
+    }
+    down = note + scale->down[pc];
+    up = note + scale->up[pc];
+    // Ties go down unless that leaves the MIDI range
+    if (down >= 0 && (note - down <= up - note || up > 127)) {
+        return down;
+    }
+    return up;
+}
+
+
+uint8_t msc_quantize_note(const msc_scale *scale,
+                          uint8_t rootnote,
+                          uint8_t note)
+{
+    return Quantize(scale, rootnote, note);
+}
+
+
+void msc_quantize(const msc_scale *scale,
+                  uint8_t rootnote,
+                  const uint8_t *notes,
+                  uint8_t *out,
+                  size_t count)
+{
+    size_t i;
+
+    for (i = 0; i < count; i++) {
+        out[i] = Quantize(scale, rootnote, notes[i]);
+    }
+}
+
+
+int msc_chord(const msc_scale *scale,
+              uint8_t rootnote,
+              int kind,
+              uint8_t degree,
+              uint32_t *chord)
+{
+    return msc_chords(scale, rootnote, kind, &degree, chord, 1);
+}
+
+
+int msc_chords(const msc_scale *scale,
+               uint8_t rootnote,
+               int kind,
+               const uint8_t *degrees,
+               uint32_t *chords,
+               size_t count)
+{
+    size_t i;
+    unsigned int n = scale->scale.notes;
+    unsigned int d, root;
+
+    if (kind < MSC_CHORD_POWER || kind > MSC_CHORD_SUS4 || n == 0) {
+        return MSC_EINVAL;
+    }
+    for (i = 0; i < count; i++) {
+        d = degrees[i] % n;
+        root = Scale::FoldNote(rootnote + scale->offset[d]);
+        chords[i] = PackedChord::Make(root, root, scale->chords[d][kind],
+                                      (Chord::Kinds)kind).bits;
+    }
+    return MSC_OK;
+}
+
+
+void msc_note_name(uint8_t note, int flags, char *name)
+{
+    msc_note_names(&note, 1, flags, name);
+}
+
+
+void msc_note_names(const uint8_t *notes,
+                    size_t count,
+                    int flags,
+                    char *names)
+{
+    size_t i;
+    const NoteNames *table;
+
+    // Building the table can run out of memory, leave the names empty
+    try {
+        table = &Names();
+    }
+    catch (...) {
+        for (i = 0; i < count; i++) {
+            names[i * MSC_NOTE_NAME_SIZE] = '\0';
+        }
+        return;
+    }
+    for (i = 0; i < count; i++) {
+        memcpy(names + i * MSC_NOTE_NAME_SIZE,
+               table->name[flags & 3][notes[i]],
+               MSC_NOTE_NAME_SIZE);
+    }
+}
+
+/* EOF */
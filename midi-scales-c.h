@@ -0,0 +1,151 @@
+/**
+ * @file midi-scales-c.h
+ * @author Jan-Willem Smaal <usenet@gispen.org>
+ * @date 19/10/2026
+ * @copyright APACHE-2.0
+ *
+ * Plain C interface to the scales, built as libmidiscales.so.
+ * Only opaque handles, integers and caller owned buffers cross
+ * the library boundary.  The batched calls handle N notes or
+ * chords per call.
+ */
+#ifndef __midi_scales_c_h
+#define __midi_scales_c_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(__GNUC__)
+#define MSC_API __attribute__((visibility("default")))
+#else
+#define MSC_API
+#endif
+
+/*
+ * Bumped whenever a function signature or constant below changes
+ */
+#define MSC_ABI_VERSION     1
+
+/* Return values */
+#define MSC_OK              0
+#define MSC_EINVAL         -1
+#define MSC_ENOSPACE       -2
+
+/* Flags for msc_note_name() and msc_note_names() */
+#define MSC_FLATS           1
+#define MSC_OCTAVE          2
+
+/* Every note name fits in this many bytes including the '\0' */
+#define MSC_NOTE_NAME_SIZE  8
+
+/*
+ * Kinds of scales, same order as Scale::ScaleKinds
+ */
+enum msc_scale_kind {
+    MSC_CHROMATIC,
+    MSC_OCTATONIC,
+    MSC_DOMINANT_DIMINISHED,
+    MSC_DIMINISHED,
+    MSC_MAJOR,
+    MSC_MINOR,
+    MSC_MELODIC_MINOR,
+    MSC_HARMONIC_MINOR,
+    MSC_GYPSY,
+    MSC_SYMETRICAL,
+    MSC_ENIGMATIC,
+    MSC_ARABIAN,
+    MSC_HUNGARIAN,
+    MSC_WHOLE_TONE,
+    MSC_AUGMENTED,
+    MSC_BLUES_MAJOR,
+    MSC_BLUES_MINOR,
+    MSC_PENTATONIC,
+    MSC_MINOR_PENTATONIC
+};
+
+/*
+ * Kinds of chords, same order as Chord::Kinds
+ */
+enum msc_chord_kind {
+    MSC_CHORD_POWER,
+    MSC_CHORD_BASIC,
+    MSC_CHORD_SEVENTH,
+    MSC_CHORD_NINE,
+    MSC_CHORD_ELEVEN,
+    MSC_CHORD_THIRTEEN,
+    MSC_CHORD_SUS4
+};
+
+typedef struct msc_scale msc_scale;
+
+/* Returns MSC_ABI_VERSION the library was built with */
+MSC_API unsigned int msc_abi_version(void);
+
+/* NULL on invalid kind/mode or when out of memory */
+MSC_API msc_scale *msc_scale_new(int kind, int mode);
+MSC_API void msc_scale_free(msc_scale *scale);
+/* MSC_EINVAL on invalid kind/mode or when out of memory,
+ * the scale is left as it was */
+MSC_API int msc_scale_set(msc_scale *scale, int kind, int mode);
+
+/* Number of notes and modes, modes is 0 for scales without modes */
+MSC_API int msc_scale_size(const msc_scale *scale);
+MSC_API int msc_scale_modes(const msc_scale *scale);
+/* Pitch classes in the scale, bit n is n semitones above the root */
+MSC_API uint16_t msc_scale_mask(const msc_scale *scale);
+
+/* Write the notes of the scale starting at rootnote, notes above
+ * 127 fold down by octaves, returns the number of notes or MSC_ENOSPACE */
+MSC_API int msc_scale_notes(const msc_scale *scale,
+                            uint8_t rootnote,
+                            uint8_t *notes,
+                            size_t count);
+
+/* Move notes to the nearest note of the scale, ties go down */
+MSC_API uint8_t msc_quantize_note(const msc_scale *scale,
+                                  uint8_t rootnote,
+                                  uint8_t note);
+MSC_API void msc_quantize(const msc_scale *scale,
+                          uint8_t rootnote,
+                          const uint8_t *notes,
+                          uint8_t *out,
+                          size_t count);
+
+/* Chords on scale degrees of the scale at rootnote,
+ * every chord is a 32 bit PackedChord (see midi-scales.h).
+ * Degrees wrap around within the octave: degree 7 of a seven
+ * note scale is degree 0 again, not the octave above.
+ * Roots above 127 fold down by octaves. */
+MSC_API int msc_chord(const msc_scale *scale,
+                      uint8_t rootnote,
+                      int kind,
+                      uint8_t degree,
+                      uint32_t *chord);
+MSC_API int msc_chords(const msc_scale *scale,
+                       uint8_t rootnote,
+                       int kind,
+                       const uint8_t *degrees,
+                       uint32_t *chords,
+                       size_t count);
+
+/* Note names, name must hold MSC_NOTE_NAME_SIZE bytes,
+ * names count * MSC_NOTE_NAME_SIZE bytes.  The names are
+ * built on first use, when out of memory they are left empty. */
+MSC_API void msc_note_name(uint8_t note,
+                           int flags,
+                           char *name);
+MSC_API void msc_note_names(const uint8_t *notes,
+                            size_t count,
+                            int flags,
+                            char *names);
+
+#ifdef __cplusplus
+}
+#endif
+
+/* End of header file  */
+#endif
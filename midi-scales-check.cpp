@@ -0,0 +1,1042 @@
+/**
+ * @file midi-scales-check.cpp
+ * @author Jan-Willem Smaal <usenet@gispen.org>
+ * @date 19/10/2026
+ * @copyright APACHE-2.0
+ *
+ * Differential check of the scale code against a straightforward
+ * reference implementation.  Built by 'make check' with ASan and
+ * UBSan it sweeps every kind x mode x root x flats combination.
+ * Built with -DMIDI_SCALES_FUZZER it is a libFuzzer target
+ * ('make midi-scales-fuzz') running the fixed table checks once
+ * and the per scale checks on the scale the input picks, then
+ * feeding the rest of the input to the binary decoders.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "midi-scales.h"
+#include "midi-scales-textcache.h"
+#include "midi-scales-spelling.h"
+#include "midi-scales-similarity.h"
+#include "midi-scales-melody.h"
+#include "midi-scales-serial.h"
+#include "midi-scales-c.h"
+
+static int failures = 0;
+
+#define CHECK(cond, what) \
+    do { \
+        if (!(cond)) { \
+            if (failures++ < 20) { \
+                std::cout << "FAIL " << __LINE__ << ": " << #cond \
+                          << " " << what << std::endl; \
+            } \
+        } \
+    } while (0)
+
+
+/*
+ * The reference: every scale as the steps of its first mode,
+ * other modes are rotations of it.
+ */
+static const struct {
+    const char *steps;
+    int modes;
+} reference[Scale::KINDS] = {
+    {"111111111111", 0},    // CHROMATIC
+    {"12121212", 2},        // OCTATONIC
+    {"12121212", 0},        // DOMINANT_DIMINISHED
+    {"21212121", 0},        // DIMINISHED
+    {"2212221", 7},         // MAJOR
+    {"2122122", 7},         // MINOR
+    {"2122221", 7},         // MELODIC_MINOR
+    {"2122131", 7},         // HARMONIC_MINOR
+    {"2131131", 0},         // GYPSY
+    {"1223112", 0},         // SYMETRICAL
+    {"1322211", 0},         // ENIGMATIC
+    {"2211222", 0},         // ARABIAN
+    {"3121212", 0},         // HUNGARIAN
+    {"222222", 0},          // WHOLE_TONE
+    {"313131", 2},          // AUGMENTED
+    {"211323", 0},          // BLUES_MAJOR
+    {"321132", 6},          // BLUES_MINOR
+    {"22323", 0},           // PENTATONIC
+    {"32232", 0}            // MINOR_PENTATONIC
+};
+
+static const char *sharpNames[12] = {
+    "C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B"
+};
+static const char *flatNames[12] = {
+    "C", "Db", "D", "Eb", "E", "F", "Gb", "G", "Ab", "A", "Bb", "B"
+};
+
+
+/** Out of range modes fall back to mode 0, scales without modes keep it
+ */
+static int RefMode(int kind, int mode)
+{
+    if (reference[kind].modes != 0 && mode >= reference[kind].modes) {
+        return 0;
+    }
+    return mode;
+}
+
+
+static int RefNotes(int kind)
+{
+    return strlen(reference[kind].steps);
+}
+
+
+static int RefStep(int kind, int mode, int i)
+{
+    int n = RefNotes(kind);
+
+    if (reference[kind].modes == 0) {
+        mode = 0;
+    }
+    return reference[kind].steps[(RefMode(kind, mode) + i) % n] - '0';
+}
+
+
+static std::string RefNoteToText(uint8_t midinote, bool flats, bool showoctave)
+{
+    std::string str = flats ? flatNames[midinote % 12] : sharpNames[midinote % 12];
+
+    if (showoctave) {
+        str += std::to_string(midinote / 12 - 2);
+    }
+    return str;
+}
+
+
+// Notes above 127 fold down by octaves, the pitch class stays the same
+static int RefFold(int note)
+{
+    return note > 127 ? 116 + (note - 116) % 12 : note;
+}
+
+
+static std::string RefText(int kind, int mode, uint8_t rootnote, bool flats)
+{
+    int i;
+    int tmp = rootnote;
+    std::string str;
+
+    for (i = 0; i < RefNotes(kind); i++) {
+        str += RefNoteToText(RefFold(tmp), flats, false) + " ";
+        tmp += RefStep(kind, mode, i);
+    }
+    return str;
+}
+
+
+static void RefTriad(int kind, int mode, uint8_t rootnote, uint8_t *notes)
+{
+    int i;
+    int tmp = rootnote;
+
+    for (i = 0; i <= 4; i++) {
+        if (i % 2 == 0) {
+            notes[i / 2] = RefFold(tmp);
+        }
+        tmp += RefStep(kind, mode, i);
+    }
+}
+
+
+static uint16_t RefMask(int kind, int mode)
+{
+    int i;
+    int tmp = 0;
+    uint16_t mask = 0;
+
+    for (i = 0; i < RefNotes(kind); i++) {
+        mask |= 1 << (tmp % 12);
+        tmp += RefStep(kind, mode, i);
+    }
+    return mask;
+}
+
+
+static int PitchClass(const std::string &name)
+{
+    static const int natural[7] = {9, 11, 0, 2, 4, 5, 7};
+    size_t i;
+    int pc = natural[name[0] - 'A'];
+
+    for (i = 1; i < name.size(); i++) {
+        pc += (name[i] == '#') ? 1 : -1;
+    }
+    return (pc + 24) % 12;
+}
+
+
+/** Whether a seven note scale can start on letter (A = 0 ... G = 6)
+ * with no more than double sharps or flats
+ */
+static bool RefFits(int kind, int mode, uint8_t rootnote, int letter)
+{
+    int i, acc;
+    int tmp = rootnote;
+
+    for (i = 0; i < 7; i++) {
+        acc = (tmp - PitchClass(std::string(1, 'A' + (letter + i) % 7)) + 126) % 12 - 6;
+        if (acc < -2 || acc > 2) {
+            return false;
+        }
+        tmp += RefStep(kind, mode, i);
+    }
+    return true;
+}
+
+
+//-----------------------------------------------------------------
+
+/** Scale::SetScale, Scale::Text and Chord against the reference,
+ * then the faster paths against those.
+ */
+static void CheckScale(int kind, uint8_t mode, uint8_t rootnote, bool flats)
+{
+    int i;
+    int n = RefNotes(kind);
+    int m = RefMode(kind, mode);
+    std::string text = RefText(kind, mode, rootnote, flats);
+    std::string what = "kind " + std::to_string(kind) +
+                       " mode " + std::to_string(mode) +
+                       " root " + std::to_string(rootnote) +
+                       " flats " + std::to_string(flats);
+    uint8_t triad[3];
+    static TextCache cache;
+    TextCache::View view;
+    PackedChord chords[12 * Chord::KINDS];
+
+    // Both ways of setting up a scale end up the same
+    Scale scl((Scale::ScaleKinds)kind, mode);
+    Scale other(Scale::ScaleKinds::CHROMATIC, 0);
+    other.SetMode(mode);
+    other.SetScale((Scale::ScaleKinds)kind);
+
+    CHECK(scl.notes == n, what);
+    CHECK(scl.modes == reference[kind].modes, what);
+    CHECK(scl.mode == m, what);
+    CHECK(other.mode == m, what);
+    CHECK(scl.modeName != "?", what);
+    for (i = 0; i < n && i < scl.notes; i++) {
+        CHECK(*(scl.ptrToScale + i) == RefStep(kind, mode, i), what);
+        CHECK(*(other.ptrToScale + i) == RefStep(kind, mode, i), what);
+    }
+    CHECK(scl.Mask() == RefMask(kind, mode), what);
+    CHECK(scl.Text(rootnote, flats) == text, what);
+
+    RefTriad(kind, mode, rootnote, triad);
+    Chord chord(&scl, Chord::Kinds::BASIC, rootnote);
+    CHECK(chord.Text(flats) == "( " + RefNoteToText(triad[0], flats, false) + "," +
+                               RefNoteToText(triad[1], flats, false) + "," +
+                               RefNoteToText(triad[2], flats, false) + ")", what);
+
+    // TextCache
+    if (rootnote < TextCache::ROOTS) {
+        CHECK(cache.ScaleText((Scale::ScaleKinds)kind, m, rootnote, flats, &view), what);
+        CHECK(view.String() == text, what);
+        CHECK(cache.ChordText((Scale::ScaleKinds)kind, m, rootnote, flats, &view), what);
+        CHECK(view.String() == chord.Text(flats), what);
+    }
+
+    // PackedChord, the triad on degree 0 is the Chord above
+    CHECK(Chord::Diatonic(scl, rootnote, chords, 12 * Chord::KINDS) == n * Chord::KINDS, what);
+    CHECK(chords[(int)Chord::Kinds::BASIC].Mask() ==
+          ((1 << 0) | (1 << (triad[1] - triad[0] + 12) % 12) |
+           (1 << (triad[2] - triad[0] + 12) % 12)), what);
+    for (i = 0; i < (int)Chord::KINDS; i++) {
+        Chord kinded(&scl, (Chord::Kinds)i, rootnote);
+        CHECK(chords[i].bits == kinded.Pack().bits, what + " chord " + std::to_string(i));
+    }
+    // Chord notes stay in MIDI range and match the mask
+    for (i = 0; i < (int)(n * Chord::KINDS); i++) {
+        uint8_t notes[12];
+        unsigned int j, count = chords[i].Notes(notes);
+        uint16_t mask = 0;
+        CHECK(count == chords[i].Size(), what);
+        for (j = 0; j < count; j++) {
+            CHECK(notes[j] <= 127, what + " chord " + std::to_string(i));
+            mask |= 1 << ((notes[j] + 12 - chords[i].Root() % 12) % 12);
+        }
+        CHECK(mask == chords[i].Mask(), what + " chord " + std::to_string(i));
+    }
+    // Stacking thirds over seven notes ends up with all of them
+    if (n == 7) {
+        CHECK(Chord(&scl, Chord::Kinds::THIRTEEN, rootnote).Pack().Mask() ==
+              RefMask(kind, mode), what);
+    }
+
+    // Spelled names are the same notes, seven note scales use every letter
+    std::string spelled = scl.Text(rootnote, flats, true);
+    std::string name;
+    size_t pos = 0, end;
+    int letters = 0;
+    int tmp = rootnote;
+    for (i = 0; (end = spelled.find(' ', pos)) != std::string::npos; i++) {
+        name = spelled.substr(pos, end - pos);
+        CHECK(PitchClass(name) == tmp % 12, what + " " + name);
+        // Natural roots keep their letter, black keys follow flats
+        // unless only the other letter fits seven notes
+        if (i == 0 && sharpNames[tmp % 12][1] == '\0') {
+            CHECK(name == sharpNames[tmp % 12], what + " " + spelled);
+        }
+        else if (i == 0) {
+            std::string preferred = flats ? flatNames[tmp % 12] : sharpNames[tmp % 12];
+            std::string other = flats ? sharpNames[tmp % 12] : flatNames[tmp % 12];
+            CHECK(name == preferred ||
+                  (name == other && n == 7 &&
+                   !RefFits(kind, mode, rootnote, preferred[0] - 'A')),
+                  what + " " + spelled);
+        }
+        // Fewer or more letters than notes never turn a white key
+        // into an accidental
+        if (n != 7 && sharpNames[tmp % 12][1] == '\0') {
+            CHECK(name.size() == 1, what + " " + spelled);
+        }
+        letters |= 1 << (name[0] - 'A');
+        tmp += RefStep(kind, mode, i);
+        pos = end + 1;
+    }
+    CHECK(i == n, what);
+    if (n == 7) {
+        CHECK(letters == 0x7f, what + " " + spelled);
+    }
+}
+
+
+/** A few keys spelled out in full
+ */
+static void CheckSpelling()
+{
+    const struct {
+        Scale::ScaleKinds kind;
+        uint8_t mode;
+        uint8_t rootnote;
+        bool flats;
+        const char *text;
+    } keys[] = {
+        {Scale::ScaleKinds::MELODIC_MINOR, 6, 60, false, "C Db Eb Fb Gb Ab Bb "},
+        {Scale::ScaleKinds::MAJOR, 6, 65, false, "F Gb Ab Bb Cb Db Eb "},
+        {Scale::ScaleKinds::MAJOR, 3, 71, true, "B C# D# E# F# G# A# "},
+        {Scale::ScaleKinds::HARMONIC_MINOR, 0, 68, false, "G# A# B C# D# E F## "},
+        {Scale::ScaleKinds::HARMONIC_MINOR, 0, 68, true, "Ab Bb Cb Db Eb Fb G "},
+        {Scale::ScaleKinds::HARMONIC_MINOR, 0, 57, false, "A B C D E F G# "},
+        {Scale::ScaleKinds::MAJOR, 0, 66, false, "F# G# A# B C# D# E# "},
+        {Scale::ScaleKinds::MAJOR, 0, 66, true, "Gb Ab Bb Cb Db Eb F "},
+        {Scale::ScaleKinds::BLUES_MINOR, 0, 57, true, "A C D Eb E G "},
+        {Scale::ScaleKinds::BLUES_MINOR, 0, 57, false, "A C D D# E G "}
+    };
+    size_t i;
+
+    for (i = 0; i < sizeof(keys) / sizeof(keys[0]); i++) {
+        Scale scl(keys[i].kind, keys[i].mode);
+        CHECK(scl.Text(keys[i].rootnote, keys[i].flats, true) == keys[i].text,
+              keys[i].text + std::string(" got ") +
+              scl.Text(keys[i].rootnote, keys[i].flats, true));
+    }
+
+    // The fifth of a blues chord stays E
+    Scale blues(Scale::ScaleKinds::BLUES_MINOR, 0);
+    Chord chord(&blues, Chord::Kinds::BASIC, 57);
+    CHECK(chord.Text(true, true) == "( A,D,E)", chord.Text(true, true));
+}
+
+
+/** Chords through the C interface are the ones Chord::Diatonic builds
+ */
+static void CheckChords(int kind, uint8_t mode, uint8_t rootnote)
+{
+    int k;
+    unsigned int d, n;
+    uint8_t degrees[24];
+    uint32_t out[24];
+    PackedChord chords[12 * Chord::KINDS];
+    std::string what = "kind " + std::to_string(kind) +
+                       " mode " + std::to_string(mode) +
+                       " root " + std::to_string(rootnote);
+    Scale scl((Scale::ScaleKinds)kind, mode);
+    msc_scale *scale = msc_scale_new(kind, scl.modes ? scl.mode : 0);
+
+    CHECK(scale != NULL, what);
+    if (scale == NULL) {
+        return;
+    }
+    n = Chord::Diatonic(scl, rootnote, chords, 12 * Chord::KINDS) / Chord::KINDS;
+    for (d = 0; d < 2 * n; d++) {
+        degrees[d] = d;
+    }
+    for (k = 0; k < (int)Chord::KINDS; k++) {
+        CHECK(msc_chords(scale, rootnote, k, degrees, out, 2 * n) == MSC_OK, what);
+        for (d = 0; d < 2 * n; d++) {
+            CHECK(out[d] == chords[(d % n) * Chord::KINDS + k].bits,
+                  what + " chord " + std::to_string(k) + " degree " + std::to_string(d));
+        }
+    }
+    CHECK(msc_chords(scale, rootnote, Chord::KINDS, degrees, out, 1) == MSC_EINVAL, what);
+
+    // The notes of the scale, none of them above 127
+    CHECK(msc_scale_notes(scale, rootnote, degrees, 12) == (int)n, what);
+    for (d = 0, k = rootnote; d < n; k += RefStep(kind, scl.mode, d++)) {
+        CHECK(degrees[d] == RefFold(k), what + " note " + std::to_string(d));
+    }
+    msc_scale_free(scale);
+}
+
+
+/** Quantizing through the C interface lands on the nearest scale note
+ */
+static void CheckQuantize(int kind, uint8_t mode, uint8_t rootnote)
+{
+    int note, d, best;
+    uint16_t mask = RefMask(kind, mode);
+    uint8_t in[128], out[128];
+    msc_scale *scale = msc_scale_new(kind, reference[kind].modes ? RefMode(kind, mode) : 0);
+
+    CHECK(scale != NULL, "kind " + std::to_string(kind));
+    if (scale == NULL) {
+        return;
+    }
+    for (note = 0; note < 128; note++) {
+        in[note] = note;
+    }
+    msc_quantize(scale, rootnote, in, out, 128);
+    for (note = 0; note < 128; note++) {
+        best = 12;
+        for (d = -6; d <= 6; d++) {
+            if (note + d >= 0 && note + d < 128 &&
+                mask & (1 << ((note + d - rootnote + 120) % 12)) &&
+                (d < 0 ? -d : d) < (best < 0 ? -best : best)) {
+                best = d;
+            }
+        }
+        CHECK(out[note] - note == best,
+              "kind " + std::to_string(kind) + " note " + std::to_string(note));
+    }
+    msc_scale_free(scale);
+}
+
+
+static void CheckNoteToText()
+{
+    int note, flags;
+
+    for (note = 0; note < 256; note++) {
+        for (flags = 0; flags < 4; flags++) {
+            CHECK(Scale::NoteToText(note, flags & 1, flags & 2) ==
+                  RefNoteToText(note, flags & 1, flags & 2),
+                  "note " + std::to_string(note));
+        }
+    }
+}
+
+
+static void CheckPrimeForms()
+{
+    int mask, n;
+
+    for (mask = 0; mask < 4096; mask++) {
+        for (n = 1; n < 12; n++) {
+            CHECK(ScaleIndex::PrimeForm(mask) ==
+                  ScaleIndex::PrimeForm(((mask << n) | (mask >> (12 - n))) & 0xfff),
+                  "mask " + std::to_string(mask));
+        }
+    }
+}
+
+
+static int RefRotate(int mask, int n)
+{
+    return ((mask >> n) | (mask << (12 - n))) & 0xfff;
+}
+
+
+static int RefDistance(int a, int b)
+{
+    int n, bit, d;
+    int best = 12;
+
+    for (n = 0; n < 12; n++) {
+        d = 0;
+        for (bit = 0; bit < 12; bit++) {
+            d += ((RefRotate(a, n) ^ b) >> bit) & 1;
+        }
+        best = d < best ? d : best;
+    }
+    return best;
+}
+
+
+/** ScaleIndex::Nearest against sorting every entry by RefDistance,
+ * the entries are the built-in scales in ScaleKinds order sharing an
+ * entry per set, then all other sets in order of their prime form
+ */
+static void CheckSimilarity()
+{
+    int kind, q, n;
+    size_t i, j, k;
+    int prime;
+    const size_t sizes[] = {0, 1, 5, 352, 400};
+    std::vector<int> entry(4096, -1);
+    std::vector<std::pair<int, std::string> > entries;
+    std::vector<std::pair<int, std::string> > expected;
+    std::vector<int> distance;
+    std::vector<ScaleIndex::Result> results;
+    ScaleIndex index;
+
+    for (kind = 0; kind < (int)Scale::KINDS; kind++) {
+        Scale scl((Scale::ScaleKinds)kind, 0);
+        prime = 4096;
+        for (n = 0; n < 12; n++) {
+            prime = std::min(prime, RefRotate(RefMask(kind, 0), n));
+        }
+        if (entry[prime] < 0) {
+            entry[prime] = entries.size();
+            entries.push_back(std::make_pair(prime, scl.scaleName));
+        }
+        else {
+            entries[entry[prime]].second += ", " + scl.scaleName;
+        }
+    }
+    for (q = 0; q < 4096; q++) {
+        prime = 4096;
+        for (n = 0; n < 12; n++) {
+            prime = std::min(prime, RefRotate(q, n));
+        }
+        CHECK(ScaleIndex::PrimeForm(q) == prime, "mask " + std::to_string(q));
+        if (entry[prime] < 0) {
+            entry[prime] = entries.size();
+            entries.push_back(std::make_pair(prime, std::string()));
+        }
+    }
+    CHECK(index.Size() == entries.size(), "size " + std::to_string(index.Size()));
+    distance.resize(entries.size());
+
+    for (q = 0; q < 4096; q++) {
+        expected.clear();
+        for (i = 0; i < entries.size(); i++) {
+            distance[i] = RefDistance(q, entries[i].first);
+        }
+        for (n = 0; n <= 12; n++) {
+            for (i = 0; i < entries.size(); i++) {
+                if (distance[i] == n) {
+                    expected.push_back(entries[i]);
+                }
+            }
+        }
+        for (k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+            if (sizes[k] != index.Size() && q % 97 != 0) {
+                continue;
+            }
+            results = index.Nearest(q, sizes[k]);
+            CHECK(results.size() == std::min(sizes[k], index.Size()),
+                  "mask " + std::to_string(q) + " k " + std::to_string(sizes[k]));
+            for (j = 0; j < results.size() && j < expected.size(); j++) {
+                CHECK(results[j].mask == expected[j].first &&
+                      results[j].name == expected[j].second &&
+                      results[j].distance == RefDistance(q, results[j].mask) &&
+                      results[j].distance == ScaleIndex::Distance(q, results[j].mask),
+                      "mask " + std::to_string(q) + " result " + std::to_string(j));
+            }
+        }
+        for (j = 0; j < 4096; j += 37) {
+            CHECK(ScaleIndex::Distance(q, j) == RefDistance(q, j),
+                  "masks " + std::to_string(q) + " " + std::to_string(j));
+        }
+    }
+
+    // Every built-in scale finds its own name at distance 0
+    for (kind = 0; kind < (int)Scale::KINDS; kind++) {
+        Scale scl((Scale::ScaleKinds)kind, 0);
+        results = index.Nearest(scl, 1);
+        CHECK(results.size() == 1 && results[0].distance == 0 &&
+              results[0].name.find(scl.scaleName) != std::string::npos,
+              "kind " + std::to_string(kind));
+    }
+
+    // Added entries come after the ones already there at the same distance
+    index.Add("Dorian", Scale(Scale::ScaleKinds::MAJOR, 1));
+    index.Add("Tritone", 0x041);
+    CHECK(index.Size() == entries.size() + 2, "size " + std::to_string(index.Size()));
+    results = index.Nearest(RefMask((int)Scale::ScaleKinds::MAJOR, 0), 3);
+    CHECK(results.size() == 3 && results[0].name == "Major, Minor" &&
+          results[1].name == "Dorian" && results[1].distance == 0 &&
+          results[2].distance == 1, "dorian");
+    results = index.Nearest(0x041 << 3, 2);
+    CHECK(results.size() == 2 && results[0].name == "" &&
+          results[1].name == "Tritone" && results[1].distance == 0, "tritone");
+}
+
+
+/** One Nearest query against the whole index sorted by distance
+ */
+static void CheckNearest(uint16_t mask, size_t k)
+{
+    size_t i;
+    static const ScaleIndex index;
+    std::vector<ScaleIndex::Result> all = index.Nearest(mask, index.Size());
+    std::vector<ScaleIndex::Result> results = index.Nearest(mask, k);
+    std::string what = "mask " + std::to_string(mask) + " k " + std::to_string(k);
+
+    CHECK(all.size() == index.Size(), what);
+    CHECK(results.size() == std::min(k, index.Size()), what);
+    for (i = 0; i < all.size(); i++) {
+        CHECK(all[i].distance == RefDistance(mask & 0xfff, all[i].mask), what);
+        CHECK(i == 0 || all[i - 1].distance <= all[i].distance, what);
+    }
+    for (i = 0; i < results.size() && i < all.size(); i++) {
+        CHECK(results[i].mask == all[i].mask && results[i].name == all[i].name, what);
+    }
+}
+
+
+/** MelodyGenerator stays on the scale, puts strong beats on chord tones
+ * and never leaps further than the model allows
+ */
+static void CheckMelody(int kind, uint8_t mode, uint8_t rootnote)
+{
+    int i, n = RefNotes(kind);
+    size_t e, count;
+    int degree, last = 0;
+    int top, tmp;
+    int pitch[128];
+    uint16_t tones;
+    const uint8_t chords[8] = {0, 3, 4, 0, 5, 1, 4, 0};
+    const size_t bars = sizeof(chords);
+    std::string what = "melody kind " + std::to_string(kind) +
+                       " mode " + std::to_string(mode) +
+                       " root " + std::to_string(rootnote);
+    MelodyModel model = MelodyModel::Default();
+    MelodyEvent events[bars * 4], again[bars * 4];
+    Scale scl((Scale::ScaleKinds)kind, mode);
+    MelodyGenerator generator(scl, rootnote, model);
+
+    // Every note of the scale from rootnote up to 127, by degree
+    top = 0;
+    for (tmp = rootnote, i = 0; tmp <= 127; tmp += RefStep(kind, mode, i++ % n)) {
+        pitch[top++] = tmp;
+    }
+
+    generator.Seed(1234);
+    count = generator.Generate(chords, bars, events, bars * 4);
+    // Less than an octave left leaves nothing to generate
+    if (top < n) {
+        CHECK(count == 0, what);
+        return;
+    }
+    CHECK(count == bars * 4, what);
+    CHECK(generator.Generate(chords, bars, events, bars * 4 - 1) == 0, what);
+
+    generator.Seed(1234);
+    CHECK(generator.Generate(chords, bars, again, bars * 4) == count, what);
+    for (e = 0; e < count; e++) {
+        CHECK(memcmp(&events[e], &again[e], sizeof(MelodyEvent)) == 0,
+              what + " event " + std::to_string(e));
+
+        degree = 0;
+        while (degree < top && pitch[degree] != events[e].note) {
+            degree++;
+        }
+        CHECK(degree < top, what + " note " + std::to_string(events[e].note));
+        CHECK(events[e].bar == e / 4 && events[e].beat == e % 4, what);
+        if (e > 0) {
+            CHECK(degree - last <= MelodyModel::MAX_LEAP &&
+                  last - degree <= MelodyModel::MAX_LEAP,
+                  what + " event " + std::to_string(e));
+        }
+        last = degree;
+
+        if (events[e].beat % model.strongEvery == 0) {
+            tones = 0;
+            for (i = 0, tmp = 0; i <= chords[e / 4] % n + 4; i++) {
+                if (i == chords[e / 4] % n || i == chords[e / 4] % n + 2 ||
+                    i == chords[e / 4] % n + 4) {
+                    tones |= 1 << (tmp % 12);
+                }
+                tmp += RefStep(kind, mode, i % n);
+            }
+            CHECK(tones & (1 << ((events[e].note - rootnote) % 12)),
+                  what + " event " + std::to_string(e));
+        }
+    }
+}
+
+
+/** Weights depend on the degree the melody is on
+ */
+static void CheckMelodyModel()
+{
+    int d;
+    size_t e;
+    const uint8_t chords[2] = {0, 0};
+    const uint8_t expected[8] = {60, 62, 62, 62, 60, 62, 62, 62};
+    MelodyEvent events[8];
+    MelodyModel model = MelodyModel::Default();
+
+    // Degree 0 only goes one up, every other degree stays where it is
+    for (d = 0; d < MelodyModel::DEGREES; d++) {
+        memset(model.step[d], 0, sizeof(model.step[d]));
+        model.step[d][MelodyModel::MAX_LEAP + (d == 0 ? 1 : 0)] = 1;
+    }
+    model.strongEvery = 4;
+    MelodyGenerator generator(Scale(Scale::ScaleKinds::MAJOR, 0), 60, model);
+    CHECK(generator.Generate(chords, 2, events, 8) == 8, "model");
+    // Bar numbers are 16 bits, more bars than that is refused
+    std::vector<uint8_t> many(0x10000, 0);
+    std::vector<MelodyEvent> out(0x10000 * 4);
+    CHECK(generator.Generate(many.data(), 0x10000, out.data(), out.size()) == 0, "bars");
+    CHECK(generator.Generate(many.data(), 0xffff, out.data(), out.size()) == 0xffff * 4, "bars");
+    CHECK(out[0xffff * 4 - 1].bar == 0xfffe, "bars");
+    for (e = 0; e < 8; e++) {
+        CHECK(events[e].note == expected[e], "model event " + std::to_string(e));
+    }
+}
+
+
+/** Every text the TextCache can hand out, in Prebuild() order
+ */
+static void TextCacheStrings(std::vector<std::string> *texts)
+{
+    unsigned int kind, mode, root, flats, modes;
+
+    for (kind = 0; kind < Scale::KINDS; kind++) {
+        modes = Scale::Modes((Scale::ScaleKinds)kind);
+        for (mode = 0; mode < (modes ? modes : 1); mode++) {
+            Scale scl((Scale::ScaleKinds)kind, mode);
+            for (root = 0; root < TextCache::ROOTS; root++) {
+                for (flats = 0; flats < 2; flats++) {
+                    Chord chord(&scl, Chord::Kinds::BASIC, root);
+                    texts->push_back(scl.Text(root, flats));
+                    texts->push_back(chord.Text(flats));
+                }
+            }
+        }
+    }
+}
+
+
+/** Identical texts share storage, the budget holds and
+ * concurrent readers see the same texts
+ */
+static void CheckTextCache()
+{
+    size_t i, t;
+    unsigned int kind, mode, root, flats, modes;
+    std::vector<std::string> texts;
+    std::vector<std::thread> threads;
+    std::atomic<int> mismatches(0);
+    TextCache::View a, b;
+
+    TextCacheStrings(&texts);
+
+    TextCache full;
+    CHECK(full.Prebuild(), "prebuild");
+    CHECK(full.Used() <= full.Budget(), "prebuild");
+    // Every octave of a root and every equal text is stored once
+    CHECK(full.ScaleText(Scale::ScaleKinds::MAJOR, 0, 60, false, &a), "");
+    CHECK(full.ScaleText(Scale::ScaleKinds::MAJOR, 0, 0, false, &b), "");
+    CHECK(a.data == b.data, "octaves share a slot");
+    CHECK(full.ScaleText(Scale::ScaleKinds::MINOR, 2, 0, false, &b), "");
+    CHECK(a.data == b.data, "equal texts share storage");
+
+    // Exactly enough budget works, one byte less doesn't
+    TextCache exact(full.Used());
+    CHECK(exact.Prebuild(), "exact budget");
+    CHECK(exact.Used() == full.Used(), "exact budget");
+    TextCache tight(full.Used() - 1);
+    CHECK(!tight.Prebuild(), "tight budget");
+    CHECK(tight.Used() <= tight.Budget(), "tight budget");
+    TextCache tiny(1000);
+    CHECK(!tiny.Prebuild(), "tiny budget");
+    CHECK(tiny.Used() <= tiny.Budget(), "tiny budget");
+    CHECK(!tiny.ScaleText(Scale::ScaleKinds::MAJOR, 0, 60, false, &a), "tiny budget");
+
+    // Readers racing the writers on an empty cache
+    TextCache shared;
+    for (t = 0; t < 4; t++) {
+        threads.push_back(std::thread([&, t]() {
+            unsigned int kind, mode, root, flats, modes;
+            size_t k, base = 0;
+            uint8_t r;
+            TextCache::View view;
+
+            for (kind = 0; kind < Scale::KINDS; kind++) {
+                modes = Scale::Modes((Scale::ScaleKinds)kind);
+                for (mode = 0; mode < (modes ? modes : 1); mode++) {
+                    for (root = 0; root < TextCache::ROOTS; root++) {
+                        for (flats = 0; flats < 2; flats++) {
+                            // Every thread walks the roots in its own order
+                            r = (root * (2 * t + 1) + 31 * t) % TextCache::ROOTS;
+                            k = base + 2 * (r * 2 + flats);
+                            if (!shared.ScaleText((Scale::ScaleKinds)kind, mode, r, flats, &view) ||
+                                view.String() != texts[k] ||
+                                !shared.ChordText((Scale::ScaleKinds)kind, mode, r, flats, &view) ||
+                                view.String() != texts[k + 1]) {
+                                mismatches++;
+                            }
+                        }
+                    }
+                    base += 4 * TextCache::ROOTS;
+                }
+            }
+        }));
+    }
+    for (t = 0; t < threads.size(); t++) {
+        threads[t].join();
+    }
+    CHECK(mismatches == 0, "threads");
+    CHECK(shared.Used() == full.Used(), "threads");
+
+    // And the prebuilt cache agrees with the texts
+    for (kind = 0, i = 0; kind < Scale::KINDS; kind++) {
+        modes = Scale::Modes((Scale::ScaleKinds)kind);
+        for (mode = 0; mode < (modes ? modes : 1); mode++) {
+            for (root = 0; root < TextCache::ROOTS; root++) {
+                for (flats = 0; flats < 2; flats++, i += 2) {
+                    CHECK(full.ScaleText((Scale::ScaleKinds)kind, mode, root, flats, &a) &&
+                          a.String() == texts[i], "");
+                    CHECK(full.ChordText((Scale::ScaleKinds)kind, mode, root, flats, &a) &&
+                          a.String() == texts[i + 1], "");
+                }
+            }
+        }
+    }
+}
+
+
+/** Scales, chords and progressions survive a round trip through
+ * the binary encoding, short or foreign buffers are refused.
+ */
+static void CheckSerial(int kind, uint8_t mode, uint8_t rootnote, bool flats)
+{
+    size_t i, n;
+    std::string what = "kind " + std::to_string(kind) +
+                       " mode " + std::to_string(mode) +
+                       " root " + std::to_string(rootnote);
+    uint8_t buf[SERIAL_PROGRESSION_SIZE(12 * Chord::KINDS)];
+    PackedChord chords[12 * Chord::KINDS];
+    ScaleView scale;
+    ChordView chord;
+    ProgressionView progression;
+
+    Scale scl((Scale::ScaleKinds)kind, mode);
+    int m = scl.modes ? scl.mode : 0;
+
+    CHECK(Serial::Encode(scl, rootnote, flats, buf, sizeof(buf)) == SERIAL_SCALE_SIZE, what);
+    CHECK(scale.Parse(buf, SERIAL_SCALE_SIZE - 1) == 0, what);
+    CHECK(scale.Parse(buf, SERIAL_SCALE_SIZE) == SERIAL_SCALE_SIZE, what);
+    CHECK(scale.Kind() == (Scale::ScaleKinds)kind, what);
+    CHECK(scale.Mode() == m, what);
+    CHECK(scale.Root() == rootnote, what);
+    CHECK(scale.Flats() == flats, what);
+    buf[0] ^= 0x30;
+    CHECK(scale.Parse(buf, SERIAL_SCALE_SIZE) == 0, what);
+
+    n = Chord::Diatonic(scl, rootnote, chords, 12 * Chord::KINDS);
+    for (i = 0; i < n; i++) {
+        CHECK(Serial::Encode(chords[i], buf, SERIAL_CHORD_SIZE) == SERIAL_CHORD_SIZE, what);
+        CHECK(chord.Parse(buf, SERIAL_CHORD_SIZE) == SERIAL_CHORD_SIZE, what);
+        CHECK(chord.Chord().bits == chords[i].bits, what);
+    }
+
+    CHECK(Serial::Encode(scl, rootnote, flats, chords, n, buf,
+                         SERIAL_PROGRESSION_SIZE(n) - 1) == 0, what);
+    CHECK(Serial::Encode(scl, rootnote, flats, chords, n, buf,
+                         sizeof(buf)) == SERIAL_PROGRESSION_SIZE(n), what);
+    CHECK(progression.Parse(buf, SERIAL_PROGRESSION_SIZE(n) - 1) == 0, what);
+    CHECK(progression.Parse(buf, sizeof(buf)) == SERIAL_PROGRESSION_SIZE(n), what);
+    CHECK(progression.Key().Kind() == (Scale::ScaleKinds)kind, what);
+    CHECK(progression.Key().Mode() == m, what);
+    CHECK(progression.Key().Root() == rootnote, what);
+    CHECK(progression.Size() == n, what);
+    for (i = 0; i < n && i < progression.Size(); i++) {
+        CHECK(progression[i].bits == chords[i].bits, what);
+    }
+
+    // Chords with stray high bits or a kind past SUS4 can't be
+    // encoded, on their own or anywhere in a progression, and the
+    // decoders refuse them as well
+    const uint32_t bad[] = {1u << 29, 1u << 31, 7u << 26};
+    for (i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        PackedChord wrong = chords[i % n];
+        wrong.bits |= bad[i];
+        CHECK(Serial::Encode(wrong, buf, SERIAL_CHORD_SIZE) == 0, what);
+        buf[0] = 0x12;
+        buf[1] = wrong.bits;
+        buf[2] = wrong.bits >> 8;
+        buf[3] = wrong.bits >> 16;
+        buf[4] = wrong.bits >> 24;
+        CHECK(chord.Parse(buf, SERIAL_CHORD_SIZE) == 0, what);
+
+        Chord::Diatonic(scl, rootnote, chords, 12 * Chord::KINDS);
+        CHECK(Serial::Encode(scl, rootnote, flats, chords, n, buf,
+                             sizeof(buf)) == SERIAL_PROGRESSION_SIZE(n), what);
+        chords[(i * 5) % n] = wrong;
+        CHECK(Serial::Encode(scl, rootnote, flats, chords, n, buf,
+                             sizeof(buf)) == 0, what);
+        buf[5 + 4 * ((i * 5) % n) + 3] |= bad[i] >> 24;
+        CHECK(progression.Parse(buf, sizeof(buf)) == 0, what);
+    }
+}
+
+
+/** The byte layout doesn't depend on the host
+ */
+static void CheckSerialLayout()
+{
+    uint8_t buf[SERIAL_CHORD_SIZE];
+    const uint8_t expect[SERIAL_CHORD_SIZE] = {0x12, 0x04, 0x03, 0x02, 0x01};
+    PackedChord chord;
+
+    chord.bits = 0x01020304;
+    Serial::Encode(chord, buf, sizeof(buf));
+    CHECK(memcmp(buf, expect, sizeof(buf)) == 0, "chord layout");
+
+    Scale scl(Scale::ScaleKinds::HARMONIC_MINOR, 3);
+    Serial::Encode(scl, 57, true, buf, sizeof(buf));
+    CHECK(buf[0] == 0x11 && buf[1] == (7 << 3 | 3) && buf[2] == (0x80 | 57), "scale layout");
+}
+
+
+/** Everything that doesn't depend on a kind, mode and root
+ */
+static void CheckTables()
+{
+    CheckNoteToText();
+    CheckSpelling();
+    CheckPrimeForms();
+    CheckSimilarity();
+    CheckMelodyModel();
+    CheckSerialLayout();
+    CheckTextCache();
+}
+
+
+#ifdef MIDI_SCALES_FUZZER
+
+/** Whatever a buffer holds, parsing it is safe and what parses
+ * encodes back to the same bytes.
+ */
+static void CheckParse(const uint8_t *data, size_t size)
+{
+    size_t i, n;
+    uint8_t buf[SERIAL_PROGRESSION_SIZE(0xffff)];
+    std::vector<PackedChord> chords;
+    ScaleView scale;
+    ChordView chord;
+    ProgressionView progression;
+
+    n = scale.Parse(data, size);
+    if (n != 0) {
+        Scale scl(scale.Kind(), scale.Mode());
+        CHECK(Serial::Encode(scl, scale.Root(), scale.Flats(), buf, sizeof(buf)) == n, "");
+        CHECK(memcmp(buf, data, n) == 0, "");
+    }
+    n = chord.Parse(data, size);
+    if (n != 0) {
+        CHECK((chord.Chord().bits >> 29) == 0, "");
+        CHECK((unsigned int)chord.Chord().Kind() < Chord::KINDS, "");
+        CHECK(Serial::Encode(chord.Chord(), buf, sizeof(buf)) == n, "");
+        CHECK(memcmp(buf, data, n) == 0, "");
+    }
+    n = progression.Parse(data, size);
+    if (n != 0) {
+        Scale scl(progression.Key().Kind(), progression.Key().Mode());
+        for (i = 0; i < progression.Size(); i++) {
+            CHECK((progression[i].bits >> 29) == 0, "");
+            CHECK((unsigned int)progression[i].Kind() < Chord::KINDS, "");
+            chords.push_back(progression[i]);
+        }
+        CHECK(Serial::Encode(scl, progression.Key().Root(), progression.Key().Flats(),
+                             chords.data(), chords.size(), buf, sizeof(buf)) == n, "");
+        CHECK(memcmp(buf, data, n) == 0, "");
+    }
+}
+
+
+/** The fixed tables don't depend on the input, check them once
+ */
+extern "C" int LLVMFuzzerInitialize(int *argc, char ***argv)
+{
+    CheckTables();
+    if (failures != 0) {
+        __builtin_trap();
+    }
+    return 0;
+}
+
+
+/** Input: kind, mode, root, flats, two bytes of pitch class set,
+ * the number of neighbours, then the bytes for the decoders
+ */
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    int kind;
+
+    if (size < 7) {
+        return 0;
+    }
+    kind = data[0] % Scale::KINDS;
+    CheckScale(kind, data[1], data[2], data[3] & 1);
+    CheckSerial(kind, data[1], data[2] & 0x7f, data[3] & 1);
+    CheckQuantize(kind, data[1], data[2] % 12);
+    CheckChords(kind, data[1], data[2]);
+    CheckMelody(kind, data[1], data[2]);
+    CheckNearest(data[4] | data[5] << 8, data[6]);
+    CheckParse(data + 7, size - 7);
+    if (failures != 0) {
+        __builtin_trap();
+    }
+    return 0;
+}
+
+#else
+
+int main()
+{
+    int kind, mode, root, flats, mask;
+
+    CheckTables();
+    for (mask = 0; mask < 0x10000; mask += 97) {
+        CheckNearest(mask, mask % 400);
+    }
+    for (kind = 0; kind < (int)Scale::KINDS; kind++) {
+        for (mode = 0; mode < 256; mode = (mode < 16) ? mode + 1 : mode + 60) {
+            for (root = 0; root < 256; root++) {
+                for (flats = 0; flats < 2; flats++) {
+                    CheckScale(kind, mode, root, flats);
+                }
+            }
+            for (root = 0; root < 12; root++) {
+                CheckQuantize(kind, mode, root);
+            }
+            for (root = 0; root < 256; root++) {
+                CheckChords(kind, mode, root);
+            }
+            for (root = 0; root < 128; root++) {
+                CheckSerial(kind, mode, root, root & 1);
+            }
+            for (root = 0; root < 256; root += (root < 96) ? 12 : 1) {
+                CheckMelody(kind, mode, root);
+            }
+        }
+    }
+
+    std::cout << (failures ? "FAILED " : "OK ") << failures << std::endl;
+    return failures ? 1 : 0;
+}
+
+#endif
+
+/* EOF */
@@ -0,0 +1,300 @@
+/**
+ * @file midi-scales-melody.cpp
+ * @author Jan-Willem Smaal <usenet@gispen.org>
+ * @date 19/10/2026
+ * @copyright APACHE 2.0
+ */
+#include <vector>
+
+#include "midi-scales.h"
+#include "midi-scales-melody.h"
+
+
+//-----------------------------------------------------------------
+
+/** MelodyRandom implements xoshiro128**
+ */
+MelodyRandom::MelodyRandom(uint64_t seed)
+{
+    Seed(seed);
+}
+
+
+void MelodyRandom::Seed(uint64_t seed)
+{
+    int i;
+    uint64_t z;
+
+    // splitmix64 spreads the seed over the whole state
+    for (i = 0; i < 4; i += 2) {
+        seed += 0x9e3779b97f4a7c15ULL;
+        z = seed;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        z = z ^ (z >> 31);
+        s[i] = (uint32_t)z;
+        s[i + 1] = (uint32_t)(z >> 32);
+    }
+}
+
+
+static inline uint32_t RotateLeft(uint32_t x, int k)
+{
+    return (x << k) | (x >> (32 - k));
+}
+
+
+uint32_t MelodyRandom::Next()
+{
+    uint32_t result = RotateLeft(s[1] * 5, 7) * 9;
+    uint32_t t = s[1] << 9;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = RotateLeft(s[3], 11);
+    return result;
+}
+
+
+uint32_t MelodyRandom::Below(uint32_t n)
+{
+    return (uint32_t)(((uint64_t)Next() * n) >> 32);
+}
+
+
+//-----------------------------------------------------------------
+
+MelodyModel MelodyModel::Default()
+{
+    int d, m;
+    MelodyModel model;
+    // -7 ... -1, stay, +1 ... +7 scale degrees
+    static const float step[MOVES] = {
+        0.01f, 0.01f, 0.02f, 0.03f, 0.06f, 0.12f, 0.30f,
+        0.10f,
+        0.30f, 0.12f, 0.06f, 0.03f, 0.02f, 0.01f, 0.01f
+    };
+
+    for (d = 0; d < DEGREES; d++) {
+        for (m = 0; m < MOVES; m++) {
+            model.step[d][m] = step[m];
+        }
+    }
+    model.beatsPerBar = 4;
+    model.strongEvery = 2;
+    model.octaves = 2;
+    return model;
+}
+
+
+//-----------------------------------------------------------------
+
+/** MelodyGenerator builds all alias tables up front
+ */
+MelodyGenerator::MelodyGenerator(const Scale &scl,
+                                 uint8_t rootnote,
+                                 const MelodyModel &model)
+    : model(model),
+      random(0),
+      rootnote(rootnote),
+      notes(scl.notes),
+      range(0)
+{
+    unsigned int i, c, s;
+    int m, d, target;
+    unsigned int octaves = model.octaves ? model.octaves : 1;
+    unsigned int offset[12] = {0};
+    uint16_t mask[12] = {0};
+    float weights[MelodyModel::MOVES];
+    float sum;
+    PackedChord chords[12 * Chord::KINDS];
+
+    if (notes == 0 || notes > 12) {
+        notes = 0;
+        return;
+    }
+    for (i = 1; i < notes; i++) {
+        offset[i] = offset[i - 1] + *(scl.ptrToScale + i - 1);
+    }
+    // The top note is the root again, stay within MIDI range
+    for (s = 0; s <= notes * octaves; s++) {
+        if (rootnote + offset[s % notes] + OCTAAF * (s / notes) > 127) {
+            break;
+        }
+        pitch.push_back(offset[s % notes] + OCTAAF * (s / notes));
+    }
+    range = pitch.size();
+    // Too close to the top for every degree, and so every chord
+    if (range < notes) {
+        notes = 0;
+        range = 0;
+        pitch.clear();
+        return;
+    }
+
+    // Chord tones of the triad on every degree
+    Chord::Diatonic(scl, 0, chords, 12 * Chord::KINDS);
+    for (c = 0; c < notes; c++) {
+        mask[c] = chords[c * Chord::KINDS + (int)Chord::Kinds::BASIC].Mask();
+    }
+
+    free.resize(range);
+    strong.resize(notes * range);
+    for (s = 0; s < range; s++) {
+        sum = 0;
+        for (m = 0; m < MelodyModel::MOVES; m++) {
+            target = (int)s + m - MelodyModel::MAX_LEAP;
+            weights[m] = (target >= 0 && target < (int)range) ? model.step[s % notes][m] : 0;
+            sum += weights[m];
+        }
+        if (sum <= 0) {
+            weights[MelodyModel::MAX_LEAP] = 1;
+        }
+        Build(weights, &free[s]);
+
+        for (c = 0; c < notes; c++) {
+            sum = 0;
+            for (m = 0; m < MelodyModel::MOVES; m++) {
+                target = (int)s + m - MelodyModel::MAX_LEAP;
+                weights[m] = 0;
+                if (target >= 0 && target < (int)range &&
+                    mask[c] & (1 << ((pitch[target] + OCTAAF - offset[c]) % OCTAAF))) {
+                    weights[m] = model.step[s % notes][m];
+                }
+                sum += weights[m];
+            }
+            // The model doesn't reach a chord tone, go to the nearest
+            for (d = 0; sum <= 0 && d <= MelodyModel::MAX_LEAP; d++) {
+                for (m = MelodyModel::MAX_LEAP - d; m <= MelodyModel::MAX_LEAP + d; m += 2 * d) {
+                    target = (int)s + m - MelodyModel::MAX_LEAP;
+                    if (target >= 0 && target < (int)range &&
+                        mask[c] & (1 << ((pitch[target] + OCTAAF - offset[c]) % OCTAAF))) {
+                        weights[m] = 1;
+                        sum = 1;
+                        break;
+                    }
+                    if (d == 0) {
+                        break;
+                    }
+                }
+            }
+            if (sum <= 0) {
+                weights[MelodyModel::MAX_LEAP] = 1;
+            }
+            Build(weights, &strong[c * range + s]);
+        }
+    }
+}
+
+
+void MelodyGenerator::Seed(uint64_t seed)
+{
+    random.Seed(seed);
+}
+
+
+/** Vose's alias method, every column is either itself or its alias
+ */
+void MelodyGenerator::Build(const float *weights, AliasTable *table)
+{
+    int i;
+    int l, g;
+    int nsmall = 0;
+    int nlarge = 0;
+    int small[MelodyModel::MOVES];
+    int large[MelodyModel::MOVES];
+    double p[MelodyModel::MOVES];
+    double sum = 0;
+
+    for (i = 0; i < MelodyModel::MOVES; i++) {
+        sum += weights[i] > 0 ? weights[i] : 0;
+    }
+    for (i = 0; i < MelodyModel::MOVES; i++) {
+        p[i] = (weights[i] > 0 ? weights[i] : 0) * MelodyModel::MOVES / sum;
+        if (p[i] < 1) {
+            small[nsmall++] = i;
+        }
+        else {
+            large[nlarge++] = i;
+        }
+    }
+    while (nsmall > 0 && nlarge > 0) {
+        l = small[--nsmall];
+        g = large[--nlarge];
+        table->threshold[l] = (uint32_t)(p[l] * 4294967296.0);
+        table->alias[l] = g;
+        p[g] = p[g] + p[l] - 1;
+        if (p[g] < 1) {
+            small[nsmall++] = g;
+        }
+        else {
+            large[nlarge++] = g;
+        }
+    }
+    // Whatever is left over is (up to rounding) exactly 1
+    while (nlarge > 0) {
+        g = large[--nlarge];
+        table->threshold[g] = 0xffffffff;
+        table->alias[g] = g;
+    }
+    while (nsmall > 0) {
+        l = small[--nsmall];
+        table->threshold[l] = 0xffffffff;
+        table->alias[l] = l;
+    }
+}
+
+
+inline uint8_t MelodyGenerator::Sample(const AliasTable &table)
+{
+    uint32_t column = random.Below(MelodyModel::MOVES);
+
+    if (random.Next() < table.threshold[column]) {
+        return column;
+    }
+    return table.alias[column];
+}
+
+
+size_t MelodyGenerator::Generate(const uint8_t *chords,
+                                 size_t bars,
+                                 MelodyEvent *events,
+                                 size_t count)
+{
+    size_t b, n = 0;
+    unsigned int t, c;
+    unsigned int state = 0;
+    bool onStrong;
+
+    // MelodyEvent::bar has 16 bits
+    if (notes == 0 || range == 0 || bars > 0xffff ||
+        count < bars * model.beatsPerBar) {
+        return 0;
+    }
+    for (b = 0; b < bars; b++) {
+        c = chords[b] % notes;
+        for (t = 0; t < model.beatsPerBar; t++) {
+            onStrong = model.strongEvery ? (t % model.strongEvery == 0) : (t == 0);
+            if (n == 0) {
+                // Start on the root of the first chord
+                state = c;
+            }
+            else if (onStrong) {
+                state = state + Sample(strong[c * range + state]) - MelodyModel::MAX_LEAP;
+            }
+            else {
+                state = state + Sample(free[state]) - MelodyModel::MAX_LEAP;
+            }
+            events[n].bar = b;
+            events[n].beat = t;
+            events[n].note = rootnote + pitch[state];
+            n++;
+        }
+    }
+    return n;
+}
+
+/* EOF */
@@ -0,0 +1,120 @@
+/**
+ * @file midi-scales-melody.h
+ * @author Jan-Willem Smaal <usenet@gispen.org>
+ * @date 19/10/2026
+ * @copyright APACHE-2.0
+ */
+#ifndef __midi_scales_melody_h_hpp
+#define __midi_scales_melody_h_hpp
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <vector>
+
+#include "midi-scales.h"
+
+
+/** MelodyRandom is a xoshiro128** generator seeded through splitmix64
+ *
+ * The same seed gives the same numbers on every platform.
+ */
+class MelodyRandom {
+    public:
+        MelodyRandom(uint64_t seed = 0);
+        void Seed(uint64_t seed);
+        uint32_t Next();
+        // In [0, n) using a multiply instead of a division
+        uint32_t Below(uint32_t n);
+    private:
+        uint32_t s[4];
+};
+
+
+/** MelodyModel holds the step and leap statistics of a melody
+ *
+ * Moves are counted in scale degrees and depend on the degree the
+ * melody is on, step[d][MAX_LEAP + 1] is the weight of going one
+ * note up the scale from degree d, step[d][MAX_LEAP - 2] of going
+ * two notes down and so on.
+ */
+struct MelodyModel {
+        static const int MAX_LEAP = 7;
+        static const int MOVES = 2 * MAX_LEAP + 1;
+        static const int DEGREES = 12;
+
+        float step[DEGREES][MOVES];
+        // Events per bar
+        uint8_t beatsPerBar;
+        // Every n-th beat of a bar is strong and lands on a chord tone
+        uint8_t strongEvery;
+        // Range of the melody above the rootnote
+        uint8_t octaves;
+
+        // Mostly steps, the odd leap, the same from every degree,
+        // 4 beats with strong 1 and 3
+        static MelodyModel Default();
+};
+
+
+/** MelodyEvent is one note of a generated melody
+ */
+struct MelodyEvent {
+        uint16_t bar;
+        uint8_t beat;
+        uint8_t note;
+};
+
+
+/** MelodyGenerator walks a Markov chain over the degrees of a Scale
+ *
+ * All sampling tables are worked out in the constructor, one alias
+ * table per scale degree for the weak beats and one per degree and
+ * chord for the strong beats.  Every generator owns its tables and
+ * random numbers so generators can run on as many threads as needed.
+ *
+ * @author Jan-Willem Smaal <usenet@gispen.org>
+ */
+class MelodyGenerator {
+    public:
+        // Constructor
+        MelodyGenerator(const Scale &scl,
+                        uint8_t rootnote,
+                        const MelodyModel &model);
+
+        void Seed(uint64_t seed);
+
+        // chords holds the scale degree of the chord root for every
+        // bar, the basic triad on it gives the chord tones.
+        // Writes bars * beatsPerBar events, returns the number written
+        // or 0 when count is too small, bars is over 65535 or the
+        // scale doesn't fit in one octave from rootnote up to 127.
+        size_t Generate(const uint8_t *chords,
+                        size_t bars,
+                        MelodyEvent *events,
+                        size_t count);
+
+    private:
+        struct AliasTable {
+            uint32_t threshold[MelodyModel::MOVES];
+            uint8_t alias[MelodyModel::MOVES];
+        };
+
+        void Build(const float *weights, AliasTable *table);
+        uint8_t Sample(const AliasTable &table);
+
+        MelodyModel model;
+        MelodyRandom random;
+        uint8_t rootnote;
+        unsigned int notes;
+        // Degrees covered by the melody
+        unsigned int range;
+        // Semitones above the rootnote for every degree in range
+        std::vector<uint8_t> pitch;
+        // free[degree], strong[chord * range + degree]
+        std::vector<AliasTable> free;
+        std::vector<AliasTable> strong;
+};
+
+
+/* End of header file  */
+#endif
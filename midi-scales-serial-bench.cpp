@@ -0,0 +1,110 @@
+/**
+ * @file midi-scales-serial-bench.cpp
+ * @author Jan-Willem Smaal <usenet@gispen.org>
+ * @date 19/10/2026
+ * @copyright APACHE-2.0
+ *
+ * Encodes and decodes progressions with the binary records of
+ * midi-scales-serial.h and with a plain text line per progression.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "midi-scales.h"
+#include "midi-scales-serial.h"
+
+#define PROGRESSIONS    100000
+#define CHORDS          8
+
+
+static double Seconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+static void Report(const char *what, double encode, double decode, size_t bytes)
+{
+    printf("%-7s encode %7.1f ns  decode %7.1f ns  %5.1f bytes per progression\n",
+           what,
+           encode * 1e9 / PROGRESSIONS,
+           decode * 1e9 / PROGRESSIONS,
+           (double)bytes / PROGRESSIONS);
+}
+
+
+int main()
+{
+    size_t i, j, n;
+    size_t bytes;
+    uint32_t sum = 0;
+    char *str;
+    char *end;
+    Scale scl(Scale::ScaleKinds::MAJOR, 0);
+    PackedChord diatonic[12 * Chord::KINDS];
+    PackedChord chords[CHORDS];
+    std::vector<uint8_t> binary(PROGRESSIONS * SERIAL_PROGRESSION_SIZE(CHORDS));
+    std::vector<char> text(PROGRESSIONS * (12 + 11 * CHORDS));
+    ProgressionView view;
+
+    n = Chord::Diatonic(scl, 60, diatonic, 12 * Chord::KINDS);
+    srand(1);
+    for (i = 0; i < CHORDS; i++) {
+        chords[i] = diatonic[rand() % n];
+    }
+
+    // Binary records
+    auto start = std::chrono::steady_clock::now();
+    bytes = 0;
+    for (i = 0; i < PROGRESSIONS; i++) {
+        bytes += Serial::Encode(scl, 60, false, chords, CHORDS,
+                                &binary[bytes], binary.size() - bytes);
+    }
+    double encode = Seconds(start);
+
+    start = std::chrono::steady_clock::now();
+    for (i = 0, n = 0; i < PROGRESSIONS; i++) {
+        n += view.Parse(&binary[n], bytes - n);
+        for (j = 0; j < view.Size(); j++) {
+            sum += view[j].bits;
+        }
+    }
+    Report("binary", encode, Seconds(start), bytes);
+
+    // One line of decimal numbers per progression
+    start = std::chrono::steady_clock::now();
+    bytes = 0;
+    for (i = 0; i < PROGRESSIONS; i++) {
+        bytes += snprintf(&text[bytes], text.size() - bytes, "%u %u %u %u",
+                          (unsigned int)scl.scale, scl.mode, 60, 0);
+        for (j = 0; j < CHORDS; j++) {
+            bytes += snprintf(&text[bytes], text.size() - bytes, " %u",
+                              (unsigned int)chords[j].bits);
+        }
+        bytes += snprintf(&text[bytes], text.size() - bytes, "\n");
+    }
+    encode = Seconds(start);
+
+    start = std::chrono::steady_clock::now();
+    str = &text[0];
+    for (i = 0; i < PROGRESSIONS; i++) {
+        for (j = 0; j < 4; j++) {
+            sum += strtoul(str, &end, 10);
+            str = end;
+        }
+        for (j = 0; j < CHORDS; j++) {
+            sum += strtoul(str, &end, 10);
+            str = end;
+        }
+    }
+    Report("text", encode, Seconds(start), bytes);
+
+    // Keep the compiler from dropping the loops
+    std::cout << "(" << sum << ")" << std::endl;
+    return 0;
+}
+
+/* EOF */
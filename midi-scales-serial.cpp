@@ -0,0 +1,207 @@
+/**
+ * @file midi-scales-serial.cpp
+ * @author Jan-Willem Smaal <usenet@gispen.org>
+ * @date 19/10/2026
+ * @copyright APACHE 2.0
+ */
+#include "midi-scales.h"
+#include "midi-scales-serial.h"
+
+#define HEADER(kind)    (SERIAL_VERSION << 4 | (kind))
+
+
+static inline void Put16(uint8_t *out, uint16_t value)
+{
+    out[0] = value & 0xff;
+    out[1] = value >> 8;
+}
+
+
+static inline void Put32(uint8_t *out, uint32_t value)
+{
+    out[0] = value & 0xff;
+    out[1] = (value >> 8) & 0xff;
+    out[2] = (value >> 16) & 0xff;
+    out[3] = value >> 24;
+}
+
+
+static inline uint16_t Get16(const uint8_t *in)
+{
+    return (uint16_t)in[0] | (uint16_t)in[1] << 8;
+}
+
+
+static inline uint32_t Get32(const uint8_t *in)
+{
+    return (uint32_t)in[0] | (uint32_t)in[1] << 8 |
+           (uint32_t)in[2] << 16 | (uint32_t)in[3] << 24;
+}
+
+
+/** The two bytes describing a scale, scales without modes store mode 0
+ */
+static bool PutScale(const Scale &scl, uint8_t rootnote, bool flats, uint8_t *out)
+{
+    unsigned int kind = (unsigned int)scl.scale;
+    uint8_t mode = scl.modes ? scl.mode : 0;
+
+    if (kind >= Scale::KINDS || mode >= 8 || rootnote > 127) {
+        return false;
+    }
+    out[0] = kind << 3 | mode;
+    out[1] = (flats ? 0x80 : 0) | rootnote;
+    return true;
+}
+
+
+//-----------------------------------------------------------------
+
+size_t Serial::Encode(const Scale &scl,
+                      uint8_t rootnote,
+                      bool flats,
+                      uint8_t *out,
+                      size_t size)
+{
+    if (size < SERIAL_SCALE_SIZE || !PutScale(scl, rootnote, flats, out + 1)) {
+        return 0;
+    }
+    out[0] = HEADER(SERIAL_SCALE);
+    return SERIAL_SCALE_SIZE;
+}
+
+
+size_t Serial::Encode(PackedChord chord,
+                      uint8_t *out,
+                      size_t size)
+{
+    if (size < SERIAL_CHORD_SIZE) {
+        return 0;
+    }
+    // Nothing a decoder would refuse goes out
+    Put32(out + 1, chord.bits);
+    if (!ChordView::Valid(out + 1)) {
+        return 0;
+    }
+    out[0] = HEADER(SERIAL_CHORD);
+    return SERIAL_CHORD_SIZE;
+}
+
+
+size_t Serial::Encode(const Scale &scl,
+                      uint8_t rootnote,
+                      bool flats,
+                      const PackedChord *chords,
+                      size_t count,
+                      uint8_t *out,
+                      size_t size)
+{
+    size_t i;
+
+    if (count > 0xffff || size < SERIAL_PROGRESSION_SIZE(count) ||
+        !PutScale(scl, rootnote, flats, out + 1)) {
+        return 0;
+    }
+    Put16(out + 3, count);
+    for (i = 0; i < count; i++) {
+        Put32(out + 5 + 4 * i, chords[i].bits);
+        if (!ChordView::Valid(out + 5 + 4 * i)) {
+            return 0;
+        }
+    }
+    out[0] = HEADER(SERIAL_PROGRESSION);
+    return SERIAL_PROGRESSION_SIZE(count);
+}
+
+
+//-----------------------------------------------------------------
+
+/** Kind and mode must fit the scale tables
+ */
+bool ScaleView::Valid(const uint8_t *body)
+{
+    unsigned int kind = body[0] >> 3;
+    unsigned int mode = body[0] & 0x7;
+    unsigned int modes;
+
+    if (kind >= Scale::KINDS) {
+        return false;
+    }
+    modes = Scale::Modes((Scale::ScaleKinds)kind);
+    return mode < (modes ? modes : 1);
+}
+
+
+size_t ScaleView::Parse(const uint8_t *buf, size_t size)
+{
+    if (size < SERIAL_SCALE_SIZE || buf[0] != HEADER(SERIAL_SCALE) ||
+        !Valid(buf + 1)) {
+        return 0;
+    }
+    p = buf + 1;
+    return SERIAL_SCALE_SIZE;
+}
+
+
+bool ChordView::Valid(const uint8_t *body)
+{
+    PackedChord chord;
+
+    chord.bits = Get32(body);
+    return (chord.bits >> 29) == 0 && (unsigned int)chord.Kind() < Chord::KINDS;
+}
+
+
+size_t ChordView::Parse(const uint8_t *buf, size_t size)
+{
+    if (size < SERIAL_CHORD_SIZE || buf[0] != HEADER(SERIAL_CHORD) ||
+        !Valid(buf + 1)) {
+        return 0;
+    }
+    p = buf + 1;
+    return SERIAL_CHORD_SIZE;
+}
+
+
+PackedChord ChordView::Chord() const
+{
+    PackedChord chord;
+
+    chord.bits = Get32(p);
+    return chord;
+}
+
+
+size_t ProgressionView::Parse(const uint8_t *buf, size_t size)
+{
+    size_t i, n;
+
+    if (size < SERIAL_PROGRESSION_SIZE(0) || buf[0] != HEADER(SERIAL_PROGRESSION) ||
+        !ScaleView::Valid(buf + 1)) {
+        return 0;
+    }
+    n = Get16(buf + 3);
+    if (size < SERIAL_PROGRESSION_SIZE(n)) {
+        return 0;
+    }
+    for (i = 0; i < n; i++) {
+        if (!ChordView::Valid(buf + 5 + 4 * i)) {
+            return 0;
+        }
+    }
+    scale.p = buf + 1;
+    count = n;
+    chords = buf + 5;
+    return SERIAL_PROGRESSION_SIZE(n);
+}
+
+
+PackedChord ProgressionView::operator[](size_t i) const
+{
+    PackedChord chord;
+
+    chord.bits = Get32(chords + 4 * i);
+    return chord;
+}
+
+/* EOF */
@@ -0,0 +1,133 @@
+/**
+ * @file midi-scales-serial.h
+ * @author Jan-Willem Smaal <usenet@gispen.org>
+ * @date 19/10/2026
+ * @copyright APACHE-2.0
+ */
+#ifndef __midi_scales_serial_h_hpp
+#define __midi_scales_serial_h_hpp
+
+#include <inttypes.h>
+#include <stddef.h>
+
+#include "midi-scales.h"
+
+/*
+ * Binary encoding of scales, chords and progressions.
+ * Every record starts with a header byte, version in the
+ * high nibble and kind of record in the low nibble.
+ * Multi byte values are little endian, whatever the host.
+ *
+ *  scale        hdr, kind << 3 | mode, flats << 7 | rootnote      3 bytes
+ *  chord        hdr, PackedChord::bits                            5 bytes
+ *  progression  hdr, scale (2 bytes), count (2 bytes),
+ *               count * PackedChord::bits                  5 + 4n bytes
+ */
+#define SERIAL_VERSION          1
+#define SERIAL_SCALE            1
+#define SERIAL_CHORD            2
+#define SERIAL_PROGRESSION      3
+
+#define SERIAL_SCALE_SIZE       3
+#define SERIAL_CHORD_SIZE       5
+#define SERIAL_PROGRESSION_SIZE(n)  (5 + 4 * (n))
+
+
+/** ScaleView reads a scale record in place
+ */
+class ScaleView {
+    public:
+        // Returns the record size or 0 when buf holds no valid record
+        size_t Parse(const uint8_t *buf, size_t size);
+
+        Scale::ScaleKinds Kind() const {
+            return (Scale::ScaleKinds)(p[0] >> 3);
+        }
+        uint8_t Mode() const {
+            return p[0] & 0x7;
+        }
+        uint8_t Root() const {
+            return p[1] & 0x7f;
+        }
+        bool Flats() const {
+            return p[1] >> 7;
+        }
+    private:
+        friend class ProgressionView;
+        // Check the two bytes after the header
+        static bool Valid(const uint8_t *body);
+        const uint8_t *p;
+};
+
+
+/** ChordView reads a chord record in place
+ */
+class ChordView {
+    public:
+        // Returns the record size or 0 when buf holds no valid record,
+        // bits above 28 must be 0 and the kind a Chord::Kinds
+        size_t Parse(const uint8_t *buf, size_t size);
+
+        PackedChord Chord() const;
+    private:
+        friend class ProgressionView;
+        friend class Serial;
+        // Check the four bytes of a PackedChord
+        static bool Valid(const uint8_t *body);
+        const uint8_t *p;
+};
+
+
+/** ProgressionView reads a progression record in place,
+ * chords are decoded one at a time on access
+ */
+class ProgressionView {
+    public:
+        // Returns the record size or 0 when the key or any chord
+        // is not valid
+        size_t Parse(const uint8_t *buf, size_t size);
+
+        // The key the progression is in
+        const ScaleView &Key() const {
+            return scale;
+        }
+        size_t Size() const {
+            return count;
+        }
+        PackedChord operator[](size_t i) const;
+    private:
+        ScaleView scale;
+        size_t count;
+        const uint8_t *chords;
+};
+
+
+/** Serial writes the records, every call returns the number of
+ * bytes written or 0 when out is too small or the input can't be
+ * encoded, like a chord ChordView would refuse.
+ *
+ * @author Jan-Willem Smaal <usenet@gispen.org>
+ */
+class Serial {
+    public:
+        static size_t Encode(const Scale &scl,
+                             uint8_t rootnote,
+                             bool flats,
+                             uint8_t *out,
+                             size_t size);
+        static size_t Encode(PackedChord chord,
+                             uint8_t *out,
+                             size_t size);
+        // The whole progression in one go, at most 65535 chords
+        static size_t Encode(const Scale &scl,
+                             uint8_t rootnote,
+                             bool flats,
+                             const PackedChord *chords,
+                             size_t count,
+                             uint8_t *out,
+                             size_t size);
+};
+
+
+/* End of header file  */
+#endif
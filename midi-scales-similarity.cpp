@@ -0,0 +1,207 @@
+/**
+ * @file midi-scales-similarity.cpp
+ * @author Jan-Willem Smaal <usenet@gispen.org>
+ * @date 19/10/2026
+ * @copyright APACHE 2.0
+ */
+#include <string>
+#include <vector>
+
+#include "midi-scales.h"
+#include "midi-scales-similarity.h"
+
+#define SETS    4096
+
+
+static inline uint16_t Rotate(uint16_t mask, unsigned int n)
+{
+    return ((mask >> n) | (mask << (OCTAAF - n))) & 0xfff;
+}
+
+
+static inline uint8_t PopCount(unsigned int x)
+{
+    return __builtin_popcount(x);
+}
+
+
+/** Prime form of every one of the 4096 sets, built on first use
+ */
+struct PrimeForms {
+    PrimeForms() {
+        unsigned int mask, n;
+        uint16_t tmp;
+
+        for (mask = 0; mask < SETS; mask++) {
+            form[mask] = mask;
+            for (n = 1; n < OCTAAF; n++) {
+                tmp = Rotate(mask, n);
+                if (tmp < form[mask]) {
+                    form[mask] = tmp;
+                }
+            }
+        }
+    }
+    uint16_t form[SETS];
+};
+
+static const PrimeForms &Forms()
+{
+    static const PrimeForms forms;
+    return forms;
+}
+
+
+//-----------------------------------------------------------------
+
+/** ScaleIndex implements k nearest scale queries
+ */
+ScaleIndex::ScaleIndex()
+{
+    unsigned int i;
+    uint16_t mask;
+    // Entry holding every prime form, -1 while there is none
+    std::vector<int> entry(SETS, -1);
+    const PrimeForms &forms = Forms();
+
+    // Built-in scales first, scales sharing a set share the entry and
+    // all their names are kept.  Modes of a scale all share one set
+    // so mode 0 is enough.
+    for (i = 0; i < Scale::KINDS; i++) {
+        Scale scl((Scale::ScaleKinds)i, 0);
+        mask = forms.form[scl.Mask()];
+        if (entry[mask] < 0) {
+            entry[mask] = masks.size();
+            Add(scl.scaleName, mask);
+        }
+        else {
+            names[entry[mask]] += ", " + scl.scaleName;
+        }
+    }
+    // Then every other set without a name
+    for (i = 0; i < SETS; i++) {
+        mask = forms.form[i];
+        if (entry[mask] < 0) {
+            entry[mask] = masks.size();
+            Add("", mask);
+        }
+    }
+}
+
+
+uint16_t ScaleIndex::PrimeForm(uint16_t mask)
+{
+    return Forms().form[mask & 0xfff];
+}
+
+
+uint8_t ScaleIndex::Distance(uint16_t a, uint16_t b)
+{
+    unsigned int n;
+    uint8_t d;
+    uint8_t best = OCTAAF;
+
+    a &= 0xfff;
+    b &= 0xfff;
+    for (n = 0; n < OCTAAF; n++) {
+        d = PopCount(Rotate(a, n) ^ b);
+        if (d < best) {
+            best = d;
+        }
+    }
+    return best;
+}
+
+
+void ScaleIndex::Add(const std::string &name, uint16_t mask)
+{
+    masks.push_back(PrimeForm(mask));
+    names.push_back(name);
+}
+
+
+void ScaleIndex::Add(const std::string &name, const Scale &scl)
+{
+    Add(name, scl.Mask());
+}
+
+
+/** Entries only hold prime forms, so the distance to the query is
+ * worked out once for every possible prime form and the scan over
+ * the entries is a table lookup.  Two passes over the entries, the
+ * first counts entries per distance to find the cut off for k.
+ */
+std::vector<ScaleIndex::Result> ScaleIndex::Nearest(uint16_t mask, size_t k) const
+{
+    unsigned int i;
+    size_t j;
+    size_t total = 0;
+    size_t atCutoff;
+    uint8_t cutoff;
+    uint8_t d;
+    uint16_t rotations[OCTAAF];
+    uint8_t distance[SETS];
+    size_t histogram[OCTAAF + 1] = {0};
+    std::vector<Result> results;
+    std::vector<Result> buckets[OCTAAF + 1];
+    const PrimeForms &forms = Forms();
+
+    mask &= 0xfff;
+    for (i = 0; i < OCTAAF; i++) {
+        rotations[i] = Rotate(mask, i);
+    }
+    for (i = 0; i < SETS; i++) {
+        distance[i] = OCTAAF;
+        if (forms.form[i] != i) {
+            continue;
+        }
+        for (j = 0; j < OCTAAF; j++) {
+            d = PopCount(rotations[j] ^ i);
+            if (d < distance[i]) {
+                distance[i] = d;
+            }
+        }
+    }
+
+    for (j = 0; j < masks.size(); j++) {
+        histogram[distance[masks[j]]]++;
+    }
+    for (cutoff = 0; cutoff < OCTAAF; cutoff++) {
+        if (total + histogram[cutoff] >= k) {
+            break;
+        }
+        total += histogram[cutoff];
+    }
+    // Only this many of the entries at the cut off distance fit
+    atCutoff = k - total;
+
+    for (j = 0; j < masks.size(); j++) {
+        d = distance[masks[j]];
+        if (d > cutoff || (d == cutoff && atCutoff == 0)) {
+            continue;
+        }
+        if (d == cutoff) {
+            atCutoff--;
+        }
+        Result result = {masks[j], d, names[j]};
+        buckets[d].push_back(result);
+    }
+    for (i = 0; i <= cutoff; i++) {
+        results.insert(results.end(), buckets[i].begin(), buckets[i].end());
+    }
+    return results;
+}
+
+
+std::vector<ScaleIndex::Result> ScaleIndex::Nearest(const Scale &scl, size_t k) const
+{
+    return Nearest(scl.Mask(), k);
+}
+
+
+size_t ScaleIndex::Size() const
+{
+    return masks.size();
+}
+
+/* EOF */
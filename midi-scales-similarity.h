@@ -0,0 +1,66 @@
+/**
+ * @file midi-scales-similarity.h
+ * @author Jan-Willem Smaal <usenet@gispen.org>
+ * @date 19/10/2026
+ * @copyright APACHE-2.0
+ */
+#ifndef __midi_scales_similarity_h_hpp
+#define __midi_scales_similarity_h_hpp
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+#include "midi-scales.h"
+
+
+/** ScaleIndex finds the scales closest to a given pitch class set
+ *
+ * Sets are 12 bit masks like Scale::Mask().  Distance is the number
+ * of pitch classes that differ (Hamming distance) after transposing
+ * one of the sets to fit the other as well as possible, so every
+ * transposition and every mode of a scale is the same set.
+ *
+ * The index starts out with the built-in Scale::ScaleKinds and every
+ * other possible set, user scales can be added on top.  Built-in
+ * scales that are the same set share one entry, e.g. "Major, Minor".
+ *
+ * @author Jan-Willem Smaal <usenet@gispen.org>
+ */
+class ScaleIndex {
+    public:
+        struct Result {
+            uint16_t mask;      // prime form of the set
+            uint8_t distance;
+            std::string name;   // comma separated, empty for sets without a name
+        };
+
+        // Constructor
+        ScaleIndex();
+
+        // The smallest of the 12 transpositions of mask
+        static uint16_t PrimeForm(uint16_t mask);
+        // Smallest Hamming distance over all transpositions
+        static uint8_t Distance(uint16_t a, uint16_t b);
+
+        // Add a named set, e.g. from a user catalog
+        void Add(const std::string &name, uint16_t mask);
+        void Add(const std::string &name, const Scale &scl);
+
+        // The k entries closest to mask, nearest first.  Ties keep
+        // the order in which entries were added.
+        std::vector<Result> Nearest(uint16_t mask, size_t k) const;
+        std::vector<Result> Nearest(const Scale &scl, size_t k) const;
+
+        size_t Size() const;
+
+    private:
+        // Prime forms of all entries, scanned on every query
+        std::vector<uint16_t> masks;
+        std::vector<std::string> names;
+};
+
+
+/* End of header file  */
+#endif
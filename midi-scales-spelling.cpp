@@ -0,0 +1,239 @@
+/**
+ * @file midi-scales-spelling.cpp
+ * @author Jan-Willem Smaal <usenet@gispen.org>
+ * @date 19/10/2026
+ * @copyright APACHE 2.0
+ */
+#include <string.h>
+
+#include "midi-scales.h"
+#include "midi-scales-spelling.h"
+
+#define LETTERS     7
+#define INFINITE    1000000
+// Pitch classes of the letters as a mask
+#define WHITE_KEYS  0xab5
+
+/*
+ * Pitch class of the letters C D E F G A B
+ */
+static const uint8_t natural[LETTERS] = {0, 2, 4, 5, 7, 9, 11};
+static const char letterNames[LETTERS] = {'C', 'D', 'E', 'F', 'G', 'A', 'B'};
+
+
+/** Accidental needed to get pitch class pc from letter, -2 ... 2
+ * or more than 2 when the letter can't be used
+ */
+static int Accidental(unsigned int letter, unsigned int pc)
+{
+    int acc = ((int)pc - natural[letter] + 18) % OCTAAF - 6;
+
+    return (acc < -2 || acc > 2) ? 6 : acc;
+}
+
+
+/** Costs are in tenths, an accidental against the
+ * preferred direction costs 1 to break ties.  A white key
+ * written with an accidental, like Fb for E, costs more
+ * than any number of repeated or skipped letters.
+ */
+static int NoteCost(int acc, unsigned int pc, bool flats)
+{
+    int cost;
+
+    if (acc == 0) {
+        cost = 0;
+    }
+    else if (WHITE_KEYS & (1 << pc)) {
+        cost = 1000;
+    }
+    else {
+        cost = (acc == 1 || acc == -1) ? 10 : 40;
+    }
+    if ((flats && acc > 0) || (!flats && acc < 0)) {
+        cost += 1;
+    }
+    return cost;
+}
+
+
+/** The natural letter of pc, or for a black key
+ * the letter above with flats and below without
+ */
+static unsigned int RootLetter(unsigned int pc, bool flats)
+{
+    unsigned int letter;
+    int acc = flats ? -1 : 1;
+
+    for (letter = 0; letter < LETTERS; letter++) {
+        if (Accidental(letter, pc) == 0) {
+            return letter;
+        }
+    }
+    for (letter = 0; letter < LETTERS; letter++) {
+        if (Accidental(letter, pc) == acc) {
+            break;
+        }
+    }
+    return letter;
+}
+
+
+/** Seven note scales take the next letter every time,
+ * others may skip a letter or, with more than seven
+ * notes, repeat one.
+ */
+static int StepCost(unsigned int from, unsigned int to, unsigned int notes)
+{
+    unsigned int step = (to + LETTERS - from) % LETTERS;
+
+    if (notes == LETTERS) {
+        return step == 1 ? 0 : INFINITE;
+    }
+    switch (step) {
+        case 0:
+            return 30;
+        case 1:
+            return 0;
+        case 2:
+            return 10;
+        default:
+            return INFINITE;
+    }
+}
+
+
+//-----------------------------------------------------------------
+
+/** Spelling implements key aware note names
+ */
+const Spelling &Spelling::Table()
+{
+    static const Spelling table;
+    return table;
+}
+
+
+Spelling::Spelling()
+{
+    unsigned int i, m;
+
+    memset(names, 0, sizeof(names));
+    for (i = 0; i < Scale::KINDS; i++) {
+        Scale scl((Scale::ScaleKinds)i, 0);
+        for (m = 0; m < (scl.modes ? scl.modes : 1u); m++) {
+            scl.SetMode(m);
+            Build(scl, i, m);
+        }
+    }
+}
+
+
+/** The letter of the root comes first, its natural letter or else
+ * the one flats asks for.  Then the cheapest letter for every other
+ * degree, the letters have to wrap around to the root again.
+ */
+void Spelling::Build(Scale &scl, unsigned int kind, unsigned int mode)
+{
+    unsigned int n = scl.notes;
+    unsigned int root, f, t, i, a, b, r;
+    unsigned int pc[12];
+    int cost[12][LETTERS];
+    uint8_t from[12][LETTERS];
+    uint8_t letter[12];
+    int best, tmp, acc;
+    char *name;
+
+    for (root = 0; root < OCTAAF; root++) {
+        pc[0] = root;
+        for (i = 1; i < n; i++) {
+            pc[i] = (pc[i - 1] + *(scl.ptrToScale + i - 1)) % OCTAAF;
+        }
+        for (f = 0; f < 2; f++) {
+            // A black key root may not fit seven letters one way,
+            // try the other letter before giving up
+            for (t = 0; t < 2; t++) {
+                r = RootLetter(root, t ? !f : f);
+                letter[0] = r;
+
+                // Cheapest way to reach every letter at every degree
+                for (b = 0; b < LETTERS; b++) {
+                    cost[0][b] = (b == r) ? 0 : INFINITE;
+                }
+                for (i = 1; i < n; i++) {
+                    for (b = 0; b < LETTERS; b++) {
+                        cost[i][b] = INFINITE;
+                        acc = Accidental(b, pc[i]);
+                        if (acc > 2) {
+                            continue;
+                        }
+                        for (a = 0; a < LETTERS; a++) {
+                            tmp = cost[i - 1][a] + StepCost(a, b, n);
+                            if (tmp < cost[i][b]) {
+                                cost[i][b] = tmp;
+                                from[i][b] = a;
+                            }
+                        }
+                        cost[i][b] += NoteCost(acc, pc[i], f);
+                    }
+                }
+                best = INFINITE;
+                for (b = 0; b < LETTERS; b++) {
+                    tmp = cost[n - 1][b] + StepCost(b, r, n);
+                    if (tmp < best) {
+                        best = tmp;
+                        letter[n - 1] = b;
+                        for (i = n - 1; i > 1; i--) {
+                            letter[i - 1] = from[i][letter[i]];
+                        }
+                    }
+                }
+                if (best < INFINITE) {
+                    break;
+                }
+            }
+
+            for (i = 0; i < n; i++) {
+                name = names[kind][mode][root][f][i];
+                if (best >= INFINITE) {
+                    // No spelling at all, stick to NoteToText
+                    strcpy(name, Scale::NoteToText(pc[i], f, false).c_str());
+                    continue;
+                }
+                acc = Accidental(letter[i], pc[i]);
+                *name++ = letterNames[letter[i]];
+                for (; acc > 0; acc--) {
+                    *name++ = '#';
+                }
+                for (; acc < 0; acc++) {
+                    *name++ = 'b';
+                }
+                *name = '\0';
+            }
+        }
+    }
+}
+
+
+const char *Spelling::Name(Scale::ScaleKinds kindOfScale,
+                           uint8_t modeOf,
+                           uint8_t rootnote,
+                           unsigned int degree,
+                           bool flats) const
+{
+    unsigned int kind = (unsigned int)kindOfScale;
+    uint8_t modes = Scale::Modes(kindOfScale);
+
+    if (kind >= Scale::KINDS) {
+        return NULL;
+    }
+    if (modes == 0) {
+        modeOf = 0;
+    }
+    else if (modeOf >= modes) {
+        return NULL;
+    }
+    return names[kind][modeOf][rootnote % OCTAAF][flats ? 1 : 0][degree % Scale::Notes(kindOfScale)];
+}
+
+/* EOF */
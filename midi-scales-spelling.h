@@ -0,0 +1,54 @@
+/**
+ * @file midi-scales-spelling.h
+ * @author Jan-Willem Smaal <usenet@gispen.org>
+ * @date 19/10/2026
+ * @copyright APACHE-2.0
+ */
+#ifndef __midi_scales_spelling_h_hpp
+#define __midi_scales_spelling_h_hpp
+
+#include <inttypes.h>
+
+#include "midi-scales.h"
+
+
+/** Spelling holds the note names of every degree of every scale
+ *
+ * Unlike Scale::NoteToText the name depends on the key, a seven note
+ * scale uses every letter once, so A harmonic minor gets a G# and
+ * D harmonic minor a Bb and a C#.  Roots on a white key keep their
+ * natural letter, on a black key flats decides between e.g. F# and
+ * Gb major unless only one of them fits the letters.  Scales with
+ * fewer or more than seven notes skip or repeat a letter rather than
+ * write a white key as Fb or E#.
+ * Double sharps and flats are written as "##" and "bb".
+ *
+ * All names are worked out once, on first use of Table().
+ *
+ * @author Jan-Willem Smaal <usenet@gispen.org>
+ */
+class Spelling {
+    public:
+        static const Spelling &Table();
+
+        // Name of a degree of the scale starting at rootnote,
+        // NULL for a scale or mode out of range
+        const char *Name(Scale::ScaleKinds kindOfScale,
+                         uint8_t modeOf,
+                         uint8_t rootnote,
+                         unsigned int degree,
+                         bool flats) const;
+
+    private:
+        Spelling();
+        void Build(Scale &scl,
+                   unsigned int kind,
+                   unsigned int mode);
+
+        // names[kind][mode][root][flats][degree]
+        char names[Scale::KINDS][Scale::MAX_MODES][12][2][12][4];
+};
+
+
+/* End of header file  */
+#endif
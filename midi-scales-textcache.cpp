@@ -0,0 +1,214 @@
+/**
+ * @file midi-scales-textcache.cpp
+ * @author Jan-Willem Smaal <usenet@gispen.org>
+ * @date 19/10/2026
+ * @copyright APACHE 2.0
+ */
+#include <string.h>
+#include <string>
+
+#include "midi-scales.h"
+#include "midi-scales-textcache.h"
+
+
+//-----------------------------------------------------------------
+
+/** TextCache interns Scale::Text and Chord::Text renderings
+ */
+TextCache::TextCache(size_t budget, bool prebuild)
+    : budget(budget > MAX_BUDGET ? MAX_BUDGET : budget),
+      used(0)
+{
+    if (TextCache::budget <= OVERHEAD) {
+        return;
+    }
+    scaleSlots.reset(new std::atomic<uint32_t>[SLOTS]());
+    chordSlots.reset(new std::atomic<uint32_t>[SLOTS]());
+    strings.reset(new uint32_t[HASH]());
+    arena.reset(new char[TextCache::budget - OVERHEAD]);
+    // Offset 0 is reserved so an empty slot can be told apart
+    used.store(1, std::memory_order_relaxed);
+
+    if (prebuild) {
+        Prebuild();
+    }
+}
+
+
+bool TextCache::Prebuild()
+{
+    unsigned int i, m, r, f;
+    unsigned int nmodes;
+    View view;
+
+    for (i = 0; i < Scale::KINDS; i++) {
+        nmodes = Scale::Modes((Scale::ScaleKinds)i);
+        nmodes = nmodes ? nmodes : 1;
+        for (m = 0; m < nmodes; m++) {
+            for (r = 0; r < OCTAAF; r++) {
+                for (f = 0; f < 2; f++) {
+                    if (!ScaleText((Scale::ScaleKinds)i, m, r, f, &view) ||
+                        !ChordText((Scale::ScaleKinds)i, m, r, f, &view)) {
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+
+bool TextCache::ScaleText(Scale::ScaleKinds kindOfScale,
+                          uint8_t modeOf,
+                          uint8_t rootnote,
+                          bool flats,
+                          View *view)
+{
+    return Lookup(scaleSlots.get(), false,
+                  kindOfScale, modeOf, rootnote, flats, view);
+}
+
+
+bool TextCache::ChordText(Scale::ScaleKinds kindOfScale,
+                          uint8_t modeOf,
+                          uint8_t rootnote,
+                          bool flats,
+                          View *view)
+{
+    return Lookup(chordSlots.get(), true,
+                  kindOfScale, modeOf, rootnote, flats, view);
+}
+
+
+size_t TextCache::Used() const
+{
+    size_t bytes = used.load(std::memory_order_relaxed);
+
+    return bytes ? OVERHEAD + bytes : 0;
+}
+
+
+size_t TextCache::Budget() const
+{
+    return budget;
+}
+
+
+/** Map the arguments onto a slot, scales without modes all share
+ * mode 0 and all octaves of the root share one slot
+ */
+bool TextCache::Slot(Scale::ScaleKinds kindOfScale,
+                     uint8_t modeOf,
+                     uint8_t rootnote,
+                     bool flats,
+                     unsigned int *index) const
+{
+    unsigned int kind = (unsigned int)kindOfScale;
+    uint8_t modes = Scale::Modes(kindOfScale);
+
+    if (kind >= Scale::KINDS || rootnote >= ROOTS || !arena) {
+        return false;
+    }
+    // Scales without modes are stored as mode 0
+    if (modes == 0) {
+        modeOf = 0;
+    }
+    else if (modeOf >= modes) {
+        return false;
+    }
+    *index = ((kind * Scale::MAX_MODES + modeOf) * OCTAAF + rootnote % OCTAAF) * 2 +
+             (flats ? 1 : 0);
+    return true;
+}
+
+
+/** Lock free on a hit, renders and interns the string on a miss
+ */
+bool TextCache::Lookup(std::atomic<uint32_t> *slots,
+                       bool chord,
+                       Scale::ScaleKinds kindOfScale,
+                       uint8_t modeOf,
+                       uint8_t rootnote,
+                       bool flats,
+                       View *view)
+{
+    unsigned int index;
+    uint32_t entry;
+
+    if (!Slot(kindOfScale, modeOf, rootnote, flats, &index)) {
+        return false;
+    }
+
+    entry = slots[index].load(std::memory_order_acquire);
+    if (entry == 0) {
+        Scale scl(kindOfScale, modeOf);
+        if (chord) {
+            Chord chd(&scl, Chord::Kinds::BASIC, rootnote);
+            entry = Intern(slots, index, chd.Text(flats));
+        }
+        else {
+            entry = Intern(slots, index, scl.Text(rootnote, flats));
+        }
+        if (entry == 0) {
+            return false;
+        }
+    }
+
+    view->data = arena.get() + (entry >> 8);
+    view->size = entry & 0xff;
+    return true;
+}
+
+
+/** Find str in the arena or copy it there, then publish it in the slot
+ */
+uint32_t TextCache::Intern(std::atomic<uint32_t> *slots,
+                           unsigned int index,
+                           const std::string &str)
+{
+    size_t i;
+    size_t offset;
+    uint32_t hash = 2166136261u;
+    uint32_t entry;
+    std::lock_guard<std::mutex> lock(writer);
+
+    // Somebody else may have been rendering the same string
+    entry = slots[index].load(std::memory_order_relaxed);
+    if (entry != 0) {
+        return entry;
+    }
+    if (str.size() > 0xff) {
+        return 0;
+    }
+
+    // FNV-1a, then probe until the string or an empty entry turns up
+    for (i = 0; i < str.size(); i++) {
+        hash = (hash ^ (uint8_t)str[i]) * 16777619u;
+    }
+    for (i = 0; i < HASH; i++) {
+        entry = strings[(hash + i) % HASH];
+        if (entry == 0) {
+            break;
+        }
+        if ((entry & 0xff) == str.size() &&
+            memcmp(arena.get() + (entry >> 8), str.data(), str.size()) == 0) {
+            slots[index].store(entry, std::memory_order_release);
+            return entry;
+        }
+    }
+
+    offset = used.load(std::memory_order_relaxed);
+    if (i == HASH || offset + str.size() > budget - OVERHEAD) {
+        return 0;
+    }
+    memcpy(arena.get() + offset, str.data(), str.size());
+    used.store(offset + str.size(), std::memory_order_relaxed);
+
+    entry = (uint32_t)(offset << 8) | (uint32_t)str.size();
+    strings[(hash + i) % HASH] = entry;
+    slots[index].store(entry, std::memory_order_release);
+    return entry;
+}
+
+/* EOF */
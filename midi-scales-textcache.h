@@ -0,0 +1,115 @@
+/**
+ * @file midi-scales-textcache.h
+ * @author Jan-Willem Smaal <usenet@gispen.org>
+ * @date 19/10/2026
+ * @copyright APACHE-2.0
+ */
+#ifndef __midi_scales_textcache_h_hpp
+#define __midi_scales_textcache_h_hpp
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "midi-scales.h"
+
+
+/** TextCache interns the output of Scale::Text and Chord::Text
+ *
+ * Every distinct rendering is computed once and copied into a single
+ * fixed size arena, renderings that come out the same are stored
+ * once.  Lookups hand out a View into that arena which stays valid
+ * for the lifetime of the cache.  Readers never take a lock, only the
+ * first render of a combination does.
+ *
+ * The text has no octaves so slots are kept per pitch class of the
+ * root.  The budget covers the slot tables as well as the arena.
+ *
+ * @author Jan-Willem Smaal <usenet@gispen.org>
+ */
+class TextCache {
+    public:
+        /** Stable, non owning reference to an interned string */
+        struct View {
+            const char *data;
+            size_t size;
+            std::string String() const {
+                return std::string(data, size);
+            }
+        };
+
+        // Rootnotes accepted, 0 ... 127
+        static const unsigned int ROOTS = 128;
+        // 128KB holds every scale and chord rendering with room to spare
+        static const size_t DEFAULT_BUDGET = 128 * 1024;
+        // Arena offsets are stored in 24 bits
+        static const size_t MAX_BUDGET = 1 << 24;
+
+        // Constructor, budget is the total size in bytes.  A budget
+        // too small for the slot tables leaves the cache empty and
+        // every lookup fails.
+        TextCache(size_t budget = DEFAULT_BUDGET,
+                  bool prebuild = false);
+
+        // Render every (scale, mode, root, flats) combination up front.
+        // Returns false when the budget ran out halfway.
+        bool Prebuild();
+
+        // Same output as Scale::Text(rootnote, flats) for the given scale.
+        // Returns false for out of range arguments or a full arena.
+        bool ScaleText(Scale::ScaleKinds kindOfScale,
+                       uint8_t modeOf,
+                       uint8_t rootnote,
+                       bool flats,
+                       View *view);
+
+        // Same output as Chord::Text(flats) for the basic triad on rootnote
+        bool ChordText(Scale::ScaleKinds kindOfScale,
+                       uint8_t modeOf,
+                       uint8_t rootnote,
+                       bool flats,
+                       View *view);
+
+        // Bytes in use, slot tables included
+        size_t Used() const;
+        size_t Budget() const;
+
+    private:
+        static const unsigned int SLOTS = Scale::KINDS * Scale::MAX_MODES * 12 * 2;
+        // Open addressing table to find strings already in the arena
+        static const unsigned int HASH = 4096;
+        static const size_t OVERHEAD = (2 * SLOTS + HASH) * sizeof(uint32_t);
+
+        bool Slot(Scale::ScaleKinds kindOfScale,
+                  uint8_t modeOf,
+                  uint8_t rootnote,
+                  bool flats,
+                  unsigned int *index) const;
+        bool Lookup(std::atomic<uint32_t> *slots,
+                    bool chord,
+                    Scale::ScaleKinds kindOfScale,
+                    uint8_t modeOf,
+                    uint8_t rootnote,
+                    bool flats,
+                    View *view);
+        uint32_t Intern(std::atomic<uint32_t> *slots,
+                        unsigned int index,
+                        const std::string &str);
+
+        size_t budget;
+        std::atomic<size_t> used;
+        std::mutex writer;
+        std::unique_ptr<char[]> arena;
+        // Each slot holds (offset << 8 | length), 0 means not rendered yet
+        std::unique_ptr<std::atomic<uint32_t>[]> scaleSlots;
+        std::unique_ptr<std::atomic<uint32_t>[]> chordSlots;
+        // Same entries by hash of the string, only used by writers
+        std::unique_ptr<uint32_t[]> strings;
+};
+
+
+/* End of header file  */
+#endif
@@ -14,6 +14,7 @@
 using namespace std;
 
 #include "midi-scales.h"
+#include "midi-scales-spelling.h"
 
 struct MidiNotes 
 {
@@ -42,18 +43,55 @@ Scale::Scale(ScaleKinds kindOfScale, uint8_t modeOf) {
 	//some exotic scales have just one mode. 
 	modes = 0;
 	// Init the class with the mode given. 
-	//mode = modeOf;
+	// SetMode() would switch the scale that is not set yet
+	mode = modeOf;
  
-    SetMode(modeOf);
     SetScale(kindOfScale);
 };
 
 
+/** Modes and notes of every kind of scale, built on first use
+ */
+struct ScaleShapes {
+    ScaleShapes() {
+        unsigned int i;
+
+        for (i = 0; i < Scale::KINDS; i++) {
+            Scale scl((Scale::ScaleKinds)i, 0);
+            modes[i] = scl.modes;
+            notes[i] = scl.notes;
+        }
+    }
+    uint8_t modes[Scale::KINDS];
+    uint8_t notes[Scale::KINDS];
+};
+
+static const ScaleShapes &Shapes()
+{
+    static const ScaleShapes shapes;
+    return shapes;
+}
+
+
+uint8_t Scale::Modes(ScaleKinds kindOfScale) {
+    unsigned int kind = (unsigned int)kindOfScale;
+
+    return kind < KINDS ? Shapes().modes[kind] : 0;
+}
+
+
+uint8_t Scale::Notes(ScaleKinds kindOfScale) {
+    unsigned int kind = (unsigned int)kindOfScale;
+
+    return kind < KINDS ? Shapes().notes[kind] : 0;
+}
+
+
 bool Scale::SetMode(uint8_t modeOf) {
-    // TODO: check if the argument is in range
+    // SetScale() falls back to mode 0 when out of range
     Scale::mode = modeOf;
     SetScale(Scale::scale);
-    return true;
+    return Scale::mode == modeOf;
 }
 
 
@@ -70,8 +108,11 @@ bool Scale::SetScale(ScaleKinds kindOfScale) {
     
     switch(kindOfScale) {
         case Scale::ScaleKinds::MAJOR:
-            ptrToScale = &major_s[mode][0];
             modes = 7;
+            if (mode >= 7) {
+                mode = 0;
+            }
+            ptrToScale = &major_s[mode][0];
             scale = Scale::ScaleKinds::MAJOR;
             scaleName = "Major";
             switch (Scale::mode) {
@@ -103,8 +144,11 @@ bool Scale::SetScale(ScaleKinds kindOfScale) {
             }
             break;
         case Scale::ScaleKinds::MINOR:
-            ptrToScale = &minor_s[mode][0];
             modes = 7;
+            if (mode >= 7) {
+                mode = 0;
+            }
+            ptrToScale = &minor_s[mode][0];
             scale = Scale::ScaleKinds::MINOR;
             scaleName = "Minor";
             switch (Scale::mode) {
@@ -135,8 +179,11 @@ bool Scale::SetScale(ScaleKinds kindOfScale) {
             }
             break;
         case Scale::ScaleKinds::MELODIC_MINOR:
-            ptrToScale = &melodic_minor[mode][0];
             modes = 7;
+            if (mode >= 7) {
+                mode = 0;
+            }
+            ptrToScale = &melodic_minor[mode][0];
             scale = Scale::ScaleKinds::MELODIC_MINOR;
             scaleName = "Melodic minor";
             switch (Scale::mode) {
@@ -168,8 +215,11 @@ bool Scale::SetScale(ScaleKinds kindOfScale) {
             
             break;
         case Scale::ScaleKinds::HARMONIC_MINOR:
-            ptrToScale = &harmonic_minor[mode][0];
             modes = 7;
+            if (mode >= 7) {
+                mode = 0;
+            }
+            ptrToScale = &harmonic_minor[mode][0];
             scale = Scale::ScaleKinds::HARMONIC_MINOR;
             scaleName = "Harmonic minor";
             switch (Scale::mode) {
@@ -238,6 +288,9 @@ bool Scale::SetScale(ScaleKinds kindOfScale) {
         case Scale::ScaleKinds::AUGMENTED:
             notes = 6;
             modes = 2;
+            if (mode >= 2) {
+                mode = 0;
+            }
             ptrToScale = &augmented[mode][0];
             scale = Scale::ScaleKinds::AUGMENTED;
             scaleName = "Augmented";
@@ -317,18 +370,37 @@ bool Scale::SetScale(ScaleKinds kindOfScale) {
 }
 
 
+/** Notes above 127 aren't MIDI notes, fold those down by octaves.
+ * Letting uint8_t wrap past 255 would land on another pitch class.
+ */
+uint8_t Scale::FoldNote(unsigned int note)
+{
+    while (note > 127) {
+        note -= OCTAAF;
+    }
+    return note;
+}
+
+
 /** Print out text representation of the scale starting at rootnote
   */
-const std::string Scale::Text(uint8_t rootnote, bool flats) 
+const std::string Scale::Text(uint8_t rootnote, bool flats, bool spelled) 
 {
 	int i;
-	uint8_t tmp; 	
+	unsigned int tmp;
 	std::string str; 
+	const char *name;
 
 	tmp = rootnote; 
 	if(notes != 0) {
 		for(i = 0; i < (unsigned int)Scale::notes ; i++){
-			str = str + NoteToText(tmp, flats, false) + " ", 
+			name = spelled ? Spelling::Table().Name(scale, mode, rootnote, i, flats) : NULL;
+			if (name != NULL) {
+				str = str + name + " ";
+			}
+			else {
+				str = str + NoteToText(FoldNote(tmp), flats, false) + " ";
+			}
 			tmp  = tmp + (unsigned int)*(ptrToScale + i); 
 		}
 	}
@@ -336,6 +408,22 @@ const std::string Scale::Text(uint8_t rootnote, bool flats)
 }
 
 
+/** Pitch class set of the scale as a 12 bit mask
+ */
+uint16_t Scale::Mask() const
+{
+    unsigned int i;
+    unsigned int tmp = 0;
+    uint16_t mask = 0;
+
+    for(i = 0; i < (unsigned int)Scale::notes; i++){
+        mask |= 1 << (tmp % OCTAAF);
+        tmp = tmp + (unsigned int)*(ptrToScale + i);
+    }
+    return mask;
+}
+
+
 /** Simply convert MIDI notename to a note (either using flats or sharps
  */
 const std::string Scale::NoteToText(uint8_t midinote,
@@ -453,23 +541,24 @@ Chord::Chord(Scale *scl,
              Kinds KindOfChord,
              uint8_t rootnote) {
     int i, j;
-    uint8_t nte = rootnote;
+    unsigned int nte = rootnote;
     
     Chord::rootnote = rootnote;
     Chord::bassnote = rootnote;
     scale = scl;
+    kind = KindOfChord;
     
     // Basic triad is the only one implemented till now.
     for(i = 0; i < (unsigned int)scl->notes ; i++){
         switch(i) {
             case 0:
-                notes[0] = nte;
+                notes[0] = Scale::FoldNote(nte);
                 break;
             case 2:
-                notes[1] = nte;
+                notes[1] = Scale::FoldNote(nte);
                 break;
             case 4:
-                notes[2] = nte;
+                notes[2] = Scale::FoldNote(nte);
                 break;
             default:
                 break;
@@ -479,11 +568,168 @@ Chord::Chord(Scale *scl,
 };
 
 
-const std::string Chord::Text(bool flats) {
-    
+const std::string Chord::Text(bool flats, bool spelled) {
+    const char *name[3];
+
+    // The triad sits on degrees 0, 2 and 4 of the scale at rootnote
+    if (spelled) {
+        name[0] = Spelling::Table().Name(scale->scale, scale->mode, rootnote, 0, flats);
+        name[1] = Spelling::Table().Name(scale->scale, scale->mode, rootnote, 2, flats);
+        name[2] = Spelling::Table().Name(scale->scale, scale->mode, rootnote, 4, flats);
+        if (name[0] != NULL) {
+            return std::string("( ") + name[0] + "," + name[1] + "," + name[2] + ")";
+        }
+    }
     return "( " + Scale::NoteToText(notes[0], flats, false) + "," +
            Scale::NoteToText(notes[1], flats, false) + "," +
         Scale::NoteToText(notes[2], flats, false) + ")";
 }
 
+
+/*
+ * Scale degrees above the chord root for every Chord::Kinds,
+ * chords are stacked on every other note of the scale just like
+ * the basic triad in the constructor.
+ */
+static const struct {
+    uint8_t count;
+    uint8_t degree[7];
+} chordDegrees[Chord::KINDS] = {
+    {2, {0,4}},                 // POWER
+    {3, {0,2,4}},               // BASIC
+    {4, {0,2,4,6}},             // SEVENTH
+    {5, {0,2,4,6,8}},           // NINE
+    {6, {0,2,4,6,8,10}},        // ELEVEN
+    {7, {0,2,4,6,8,10,12}},     // THIRTEEN
+    {3, {0,3,4}}                // SUS4
+};
+
+
+/** Semitones above the root for every note of the scale,
+ * returns the number of notes
+ */
+static unsigned int ScaleOffsets(const Scale &scl, unsigned int *offset)
+{
+    unsigned int i;
+
+    offset[0] = 0;
+    for(i = 1; i < scl.notes; i++) {
+        offset[i] = offset[i - 1] + *(scl.ptrToScale + i - 1);
+    }
+    return scl.notes;
+}
+
+
+/** Interval mask of chord kind k stacked on degree i of the scale
+ */
+static uint16_t ChordMask(const unsigned int *offset,
+                          unsigned int n,
+                          unsigned int i,
+                          unsigned int k)
+{
+    unsigned int j, d;
+    uint16_t mask = 0;
+
+    for(j = 0; j < chordDegrees[k].count; j++) {
+        d = i + chordDegrees[k].degree[j];
+        mask |= 1 << ((offset[d % n] + OCTAAF * (d / n) - offset[i]) % OCTAAF);
+    }
+    return mask;
+}
+
+
+/** The chord is always built on the first degree of the scale,
+ * like the triad in the constructor
+ */
+PackedChord Chord::Pack() const {
+    unsigned int n;
+    unsigned int offset[12];
+
+    n = ScaleOffsets(*scale, offset);
+    return PackedChord::Make(Scale::FoldNote(rootnote), Scale::FoldNote(bassnote),
+                             ChordMask(offset, n, 0, (unsigned int)kind), kind);
+}
+
+
+size_t Chord::Diatonic(const Scale &scl,
+                       uint8_t rootnote,
+                       PackedChord *out,
+                       size_t count) {
+    unsigned int i, k;
+    unsigned int n = scl.notes;
+    unsigned int root;
+    // Semitones above rootnote for every note of the scale
+    unsigned int offset[12];
+
+    if (n == 0 || n > 12 || count < n * KINDS) {
+        return 0;
+    }
+    ScaleOffsets(scl, offset);
+
+    for(i = 0; i < n; i++) {
+        root = Scale::FoldNote(rootnote + offset[i]);
+        for(k = 0; k < KINDS; k++) {
+            out[i * KINDS + k] = PackedChord::Make(root, root,
+                                                   ChordMask(offset, n, i, k),
+                                                   (Kinds)k);
+        }
+    }
+    return n * KINDS;
+}
+
+
+size_t Chord::Diatonic(Scale::ScaleKinds kindOfScale,
+                       uint8_t modeOf,
+                       uint8_t rootnote,
+                       PackedChord *out,
+                       size_t count) {
+    Scale scl(kindOfScale, modeOf);
+
+    return Diatonic(scl, rootnote, out, count);
+}
+
+
+//-----------------------------------------------------------------
+
+/** PackedChord is the 32 bit value version of Chord
+  */
+PackedChord PackedChord::Make(uint8_t rootnote,
+                              uint8_t bassnote,
+                              uint16_t mask,
+                              Chord::Kinds kindOfChord) {
+    PackedChord chord;
+
+    chord.bits = (uint32_t)(rootnote & 0x7f) |
+                 (uint32_t)(bassnote & 0x7f) << 7 |
+                 (uint32_t)(mask & 0xfff) << 14 |
+                 (uint32_t)((unsigned int)kindOfChord & 0x7) << 26;
+    return chord;
+}
+
+
+unsigned int PackedChord::Size() const {
+    unsigned int i;
+    unsigned int n = 0;
+
+    for(i = 0; i < OCTAAF; i++) {
+        if (Mask() & (1 << i)) {
+            n++;
+        }
+    }
+    return n;
+}
+
+
+unsigned int PackedChord::Notes(uint8_t *notes) const {
+    unsigned int i;
+    unsigned int n = 0;
+
+    for(i = 0; i < OCTAAF; i++) {
+        if (Mask() & (1 << i)) {
+            notes[n++] = Scale::FoldNote(Root() + i);
+        }
+    }
+    return n;
+}
+
 /* EOF */ 
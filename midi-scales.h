@@ -8,7 +8,9 @@
 #define __midi_scales_h_hpp 
 
 #include <inttypes.h>
+#include <stddef.h>
 #include <string>
+#include <type_traits>
 
 /*
  * "Intervallen" in Dutch
@@ -87,6 +89,13 @@ class Scale {
             PENTATONIC,
             MINOR_PENTATONIC
         };
+        // Number of ScaleKinds and the highest number of modes
+        static const unsigned int KINDS = (unsigned int)ScaleKinds::MINOR_PENTATONIC + 1;
+        static const unsigned int MAX_MODES = 7;
+        // Modes and notes of a kind of scale without building one,
+        // Modes() is 0 for scales without modes
+        static uint8_t Modes(ScaleKinds kindOfScale);
+        static uint8_t Notes(ScaleKinds kindOfScale);
 
 		// Constructor
         Scale(ScaleKinds kindOfScale,
@@ -105,11 +114,17 @@ class Scale {
         // Max number of modes starting with 0 == first mode
     	uint8_t modes;
     	// These don't modify the Object
+        // spelled names the notes after the key, see Spelling
         const std::string Text(uint8_t rootnote,
-                               bool flats);
+                               bool flats,
+                               bool spelled = false);
 		static const std::string NoteToText(uint8_t midinote,
                                      bool flats,
                                      bool showoctave);
+        // Pitch classes in the scale, bit n is n semitones above the root
+        uint16_t Mask() const;
+        // Notes above 127 fold down by octaves onto the same pitch class
+        static uint8_t FoldNote(unsigned int note);
 	//private:
 		uint8_t *ptrToScale; 
 		       
@@ -319,6 +334,8 @@ class Scale {
 
 /////////////////////////////////////////////////////
 
+struct PackedChord;
+
 /** Chord implements chords and inversions
   */
 class Chord {
@@ -345,15 +362,78 @@ class Chord {
         // Invert the chord leaving the bassnote intact
         void Invert(unsigned int);
         // Return a text representation of the chord
-        const std::string Text(bool flats);
+        const std::string Text(bool flats,
+                               bool spelled = false);
+        // Return the chord as a value without the Scale pointer
+        PackedChord Pack() const;
+
+        // Number of Kinds
+        static const unsigned int KINDS = (unsigned int)Kinds::SUS4 + 1;
+        // Write every kind of chord on every degree of the scale
+        // starting at rootnote into out, out[degree * KINDS + kind].
+        // Returns the number of chords written (notes * KINDS) or 0
+        // when count is too small.
+        static size_t Diatonic(const Scale &scl,
+                               uint8_t rootnote,
+                               PackedChord *out,
+                               size_t count);
+        static size_t Diatonic(Scale::ScaleKinds kindOfScale,
+                               uint8_t modeOf,
+                               uint8_t rootnote,
+                               PackedChord *out,
+                               size_t count);
     private:
         Scale *scale;
+        Kinds kind;
         uint8_t notes[3];
         uint8_t rootnote;
         uint8_t bassnote;
  };
 
 
+/** PackedChord is a chord in 32 bits, without a pointer to a Scale
+ *
+ *  bits  0..6   rootnote
+ *  bits  7..13  bassnote
+ *  bits 14..25  interval mask, bit n means n semitones above the root
+ *  bits 26..28  Chord::Kinds
+ *
+ * It is trivially copyable so arrays of them can be memcpy'd around.
+ */
+struct PackedChord {
+        uint32_t bits;
+
+        static PackedChord Make(uint8_t rootnote,
+                                uint8_t bassnote,
+                                uint16_t mask,
+                                Chord::Kinds kindOfChord);
+
+        uint8_t Root() const {
+            return bits & 0x7f;
+        }
+        uint8_t Bass() const {
+            return (bits >> 7) & 0x7f;
+        }
+        uint16_t Mask() const {
+            return (bits >> 14) & 0xfff;
+        }
+        Chord::Kinds Kind() const {
+            return (Chord::Kinds)((bits >> 26) & 0x7);
+        }
+        // Number of different notes in the chord
+        unsigned int Size() const;
+        // Write the notes from the root up into notes[12], notes
+        // above 127 fold down by octaves so they are only ascending
+        // when the chord fits.  Returns the number of notes written
+        unsigned int Notes(uint8_t *notes) const;
+};
+
+static_assert(sizeof(PackedChord) == 4,
+              "PackedChord must fit in 32 bits");
+static_assert(std::is_trivially_copyable<PackedChord>::value,
+              "PackedChord must be trivially copyable");
+
+
 /* End of header file  */ 
 #endif 
 	